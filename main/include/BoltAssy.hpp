@@ -4,6 +4,12 @@
 #include <random>
 #include <iostream>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "DeadPortElimination.hpp"
+#include "MemoryAccounting.hpp"
+#include "ShotTrace.hpp"
+#include "RifleMetrics.hpp"
+#include "RifleRandom.hpp"
+#include "RifleTransitionTables.hpp"
 
 using namespace cadmium;
 
@@ -12,9 +18,11 @@ struct BoltAssyState {
     enum class States {PASSIVE, ACTIVE};
     States currentState;
     int tempMsgVal, boltFree, readyBullet, boltState;
+    std::uint32_t shot;  // Traced shot opened when the bolt was freed (SHOT_TRACE)
+    double clock;        // Simulation time of the last transition
     
     
-    explicit BoltAssyState() : sigma(1), tempMsgVal(0), boltFree(0), readyBullet(0), boltState(0) {}
+    explicit constexpr BoltAssyState() : sigma(1), currentState(States::PASSIVE), tempMsgVal(0), boltFree(0), readyBullet(0), boltState(0), shot(0), clock(0) {}
 };
 
 #ifndef NO_LOGGING
@@ -28,7 +36,7 @@ std::ostream& operator<<(std::ostream &out, const BoltAssyState& state) {
 }
 #endif
 
-class BoltAssy : public Atomic<BoltAssyState> {
+class BoltAssy : public Atomic<BoltAssyState>, public PrunableOutputs, public AccountedModel {
 public:
 
     Port<int> in_bulletReady;
@@ -49,35 +57,74 @@ public:
 
     
     void internalTransition(BoltAssyState& state) const override {
+        auto scope = memScope();
+        state.clock += state.sigma;
+        countEvent(state.clock);
        
         state.sigma = std::numeric_limits<double>::infinity();
         state.currentState = BoltAssyState::States::PASSIVE;
     }
 
 
+    // Table-driven external transition (see RifleTransitionTables.hpp)
     void externalTransition(BoltAssyState& state, double e) const override {
+        auto scope = memScope();
+        state.clock += e;
+        countEvent(state.clock);
+    #ifdef REFERENCE_TRANSITIONS
+        externalTransitionReference(state, e);
+    #else
+        if (!in_bulletReady->empty()) {
+            state.readyBullet = shotValue(in_bulletReady->getBag().back());
+        }
+
+        bool releasePresent = !in_releaseBolt->empty();
+        int release = releasePresent ? in_releaseBolt->getBag().back() : 0;
+        int back = in_boltBack->empty() ? 0 : in_boltBack->getBag().back();
+        if (!releasePresent && shotValue(back) == 1) {
+            stampShot(shotOf(back), ShotStage::BOLT_BACK, state.clock);
+        }
+
+        const BoltStep& step = BOLT_TRANSITIONS[boltCode(state.boltState, state.boltFree, state.readyBullet,
+                                                         releasePresent, shotValue(release) == 1, shotValue(back) == 1)];
+        // Random outcome picks the column: 90% chance a ready bullet loads
+        state.boltState = step.boltState[uniformDraw() >= 0.90];
+        state.boltFree = step.boltFree;
+        state.readyBullet = step.clearReady ? 0 : state.readyBullet;
+        state.currentState = step.activate ? BoltAssyState::States::ACTIVE : state.currentState;
+        state.sigma = step.activate ? 0.0 : state.sigma;
+        // A pull that frees the bolt opens a new traced shot
+        state.shot = step.released ? beginShot(state.clock) : state.shot;
+    #endif
+    }
+
+    // Hand-written reference for the table above
+    void externalTransitionReference(BoltAssyState& state, double e) const {
      
         if (!in_bulletReady->empty()) {
-            state.readyBullet = in_bulletReady->getBag().back();  
+            state.readyBullet = shotValue(in_bulletReady->getBag().back());  
         }
 
         if (!in_releaseBolt->empty()) {
-            if (in_releaseBolt->getBag().back() == 1 && state.boltState == 1) {
+            int release = in_releaseBolt->getBag().back();
+            if (shotValue(release) == 1 && state.boltState == 1) {
                 state.boltFree = 1;  // Release the bolt if it is pulled back
+                state.shot = beginShot(state.clock);
             }
         } else if (!in_boltBack->empty()) {
-            if (in_boltBack->getBag().back() == 1 && state.boltState == 0) {
+            int back = in_boltBack->getBag().back();
+            if (shotValue(back) == 1) {
+                stampShot(shotOf(back), ShotStage::BOLT_BACK, state.clock);
+            }
+            if (shotValue(back) == 1 && state.boltState == 0) {
                 state.boltState = 1;  // Move bolt back if it is forward
-            } else if (in_boltBack->getBag().back() == 1 && state.boltState == 1) {
+            } else if (shotValue(back) == 1 && state.boltState == 1) {
                 state.boltState = 0;  // Move bolt forward if it is already back
             }
         }
 
         // Generate a random value for bullet loading with a 90% success rate
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0.0, 1.0);
-        double randVal = dis(gen); 
+        double randVal = uniformDraw(); 
 
         if (state.boltFree == 1 && state.boltState == 1) {
             if (state.readyBullet == 1) {
@@ -101,21 +148,33 @@ public:
 
     // Output function
     void output(const BoltAssyState& state) const override {
+        auto scope = memScope();
        
-        if (state.boltState == 0) {
-            out_bulletLoaded->addMessage(1);  // Bullet loaded successfully
-        } else if (state.boltState == 2) {
-            out_bulletLoaded->addMessage(0);  // No bullet loaded (issue)
+        if (live(out_bulletLoaded)) {
+            if (state.boltState == 0) {
+                out_bulletLoaded->addMessage(tagShot(1, state.shot));  // Bullet loaded successfully
+            } else if (state.boltState == 2) {
+                out_bulletLoaded->addMessage(tagShot(0, state.shot));  // No bullet loaded (issue)
+            }
         }
+        if (state.boltState == 2) {
+            countMetric(&RifleMetrics::jams);
+        }
+        stampShot(state.shot, ShotStage::FEED, state.clock + state.sigma);
 
         // Output the current state of the bolt (0 = forward, 1 = back, 2 = issue)
-        out_boltPosn->addMessage(state.boltState);
+        if (live(out_boltPosn)) {
+            out_boltPosn->addMessage(state.boltState);
+        }
     }
 
     // Time advance function
     [[nodiscard]] double timeAdvance(const BoltAssyState& state) const override {
         return state.sigma;  
     }
+
+    [[nodiscard]] const BoltAssyState& getState() const { return state; }
+    void setState(const BoltAssyState& snapshot) { state = snapshot; }
 };
 
 #endif // BOLTASSY_HPP
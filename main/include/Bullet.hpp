@@ -5,6 +5,11 @@
 #include <iostream>
 #include <limits>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "DeadPortElimination.hpp"
+#include "MemoryAccounting.hpp"
+#include "ShotTrace.hpp"
+#include "RifleMetrics.hpp"
+#include "RifleRandom.hpp"
 
 using namespace cadmium;
 
@@ -14,12 +19,16 @@ struct BulletState {
     States currentState;
     int bulletRdy = 0;
     int isDud = 0;
+    std::uint32_t shot = 0;  // Traced shot being checked (SHOT_TRACE)
+    double clock = 0;        // Simulation time of the last transition
 
-    explicit BulletState() 
+    explicit constexpr BulletState() 
         : sigma(1), 
           currentState(States::PASSIVE), 
           bulletRdy(0), 
-          isDud(0) {}
+          isDud(0),
+          shot(0),
+          clock(0) {}
 };
 
 #ifndef NO_LOGGING
@@ -32,7 +41,7 @@ std::ostream& operator<<(std::ostream &out, const BulletState& state) {
 }
 #endif
 
-class Bullet : public Atomic<BulletState> {
+class Bullet : public Atomic<BulletState>, public PrunableOutputs, public AccountedModel {
 public:
     Port<int> in_bulletReady;
     Port<int> out_isDud;
@@ -49,20 +58,24 @@ public:
 
     // Internal transition
     void internalTransition(BulletState& state) const override {
+        auto scope = memScope();
+        state.clock += state.sigma;
+        countEvent(state.clock);
         state.currentState = BulletState::States::PASSIVE;
         state.sigma = std::numeric_limits<double>::infinity();
     }
 
     // External transition
     void externalTransition(BulletState& state, double e) const override {
+        auto scope = memScope();
+        state.clock += e;
+        countEvent(state.clock);
         if (!in_bulletReady->empty()) {
-            state.bulletRdy = in_bulletReady->getBag().back(); 
+            state.bulletRdy = shotValue(in_bulletReady->getBag().back());
+            state.shot = shotOf(in_bulletReady->getBag().back());
         }
         // Random number generation to determine if the bullet is a dud (95% chance it is not a dud)
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_real_distribution<> dis(0.0, 1.0);
-        double randVal = dis(gen);
+        double randVal = uniformDraw();
 
         if (randVal < 0.95) {
             state.isDud = 0;  // Not a dud
@@ -76,14 +89,26 @@ public:
 
     // Output function
     void output(const BulletState& state) const override {
-        out_isDud->addMessage(state.isDud);      
-        out_bulletReady->addMessage(state.bulletRdy); 
+        auto scope = memScope();
+        if (live(out_isDud)) {
+            out_isDud->addMessage(tagShot(state.isDud, state.shot));
+        }
+        if (live(out_bulletReady)) {
+            out_bulletReady->addMessage(tagShot(state.bulletRdy, state.shot));
+        }
+        stampShot(state.shot, ShotStage::DUD_CHECK, state.clock + state.sigma);
+        if (state.isDud == 1) {
+            countMetric(&RifleMetrics::duds);
+        }
     }
 
     // Time advance function
     [[nodiscard]] double timeAdvance(const BulletState& state) const override {
         return state.sigma;
     }
+
+    [[nodiscard]] const BulletState& getState() const { return state; }
+    void setState(const BulletState& snapshot) { state = snapshot; }
 };
 
 #endif // BULLET_HPP
\ No newline at end of file
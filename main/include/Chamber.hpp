@@ -4,6 +4,10 @@
 #include <random>
 #include <iostream>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "DeadPortElimination.hpp"
+#include "MemoryAccounting.hpp"
+#include "ShotTrace.hpp"
+#include "RifleMetrics.hpp"
 
 using namespace cadmium;
 
@@ -13,8 +17,10 @@ struct ChamberState {
     double sigma;
     int dudBullet; 
     int bulletIn;
+    std::uint32_t shot;  // Traced shot in the chamber (SHOT_TRACE)
+    double clock;        // Simulation time of the last transition
     
-    explicit ChamberState(): sigma(1), currentState(States::PASSIVE), dudBullet(2), bulletIn(0){
+    explicit constexpr ChamberState(): sigma(1), currentState(States::PASSIVE), dudBullet(2), bulletIn(0), shot(0), clock(0){
     }
 };
 
@@ -25,7 +31,7 @@ std::ostream& operator<<(std::ostream &out, const ChamberState& state) {
 }
 #endif
 
-class Chamber : public Atomic<ChamberState> {
+class Chamber : public Atomic<ChamberState>, public PrunableOutputs, public AccountedModel {
 public:
 
     Port<int> in_isDud;
@@ -44,31 +50,51 @@ public:
 
     // internal transition
     void internalTransition(ChamberState& state) const override {
+        auto scope = memScope();
+        state.clock += state.sigma;
+        countEvent(state.clock);
         // Reset the variables after firing
         state.currentState = ChamberState::States::PASSIVE;
         state.dudBullet = 2;        // Clear the dudBullet variable
         state.bulletIn = 0;         // Clear the bulletIn variable
+        state.shot = 0;
         state.sigma = std::numeric_limits<double>::infinity();  // No further events
     }
 
     // external transition
     void externalTransition(ChamberState& state, double e) const override {
+        auto scope = memScope();
+        state.clock += e;
+        countEvent(state.clock);
         if (!in_isDud->empty()) {
-            state.dudBullet = in_isDud->getBag().back();
+            state.dudBullet = shotValue(in_isDud->getBag().back());
         }
 
         if (!in_bulletLoaded->empty()) {
-            state.bulletIn = in_bulletLoaded->getBag().back();
+            state.bulletIn = shotValue(in_bulletLoaded->getBag().back());
+            state.shot = shotOf(in_bulletLoaded->getBag().back());
+            if (state.bulletIn == 1) {
+                stampShot(state.shot, ShotStage::CHAMBER, state.clock);
+            }
             state.sigma = 5.0; 
         }
     }
     
     // output function
     void output(const ChamberState& state) const override {
+        auto scope = memScope();
         if ((state.dudBullet == 0) && (state.bulletIn == 1)) {
-            out_boltBack->addMessage(1);    // bolt is back
-            out_bulletFired->addMessage(1); // Bullet fired
-            out_casing->addMessage(1);     // Casing ejected
+            if (live(out_boltBack)) {
+                out_boltBack->addMessage(tagShot(1, state.shot));    // bolt is back
+            }
+            if (live(out_bulletFired)) {
+                out_bulletFired->addMessage(1); // Bullet fired
+            }
+            if (live(out_casing)) {
+                out_casing->addMessage(1);     // Casing ejected
+            }
+            stampShot(state.shot, ShotStage::FIRE, state.clock + state.sigma);
+            countMetric(&RifleMetrics::roundsFired);
         }
     }
 
@@ -76,6 +102,9 @@ public:
     [[nodiscard]] double timeAdvance(const ChamberState& state) const override {     
         return state.sigma; 
     }
+
+    [[nodiscard]] const ChamberState& getState() const { return state; }
+    void setState(const ChamberState& snapshot) { state = snapshot; }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef DEADPORTELIMINATION_HPP
+#define DEADPORTELIMINATION_HPP
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "cadmium/modeling/devs/coupled.hpp"
+
+using namespace cadmium;
+
+// Mixin for atomics whose output ports can be switched off once the model is finalized.
+// Output functions wrap addMessage() in live(port) so a pruned port never stores a message,
+// which in turn means the simulator has nothing to route, log or clear for it.
+class PrunableOutputs {
+public:
+    virtual ~PrunableOutputs() = default;
+
+    void prune(const PortInterface* port) {
+        pruned.push_back(port);
+    }
+
+protected:
+    template <typename T>
+    [[nodiscard]] bool live(const Port<T>& port) const {
+        return pruned.empty() || std::find(pruned.begin(), pruned.end(), port.get()) == pruned.end();
+    }
+
+private:
+    std::vector<const PortInterface*> pruned;
+};
+
+struct DeadPortReport {
+    std::vector<std::string> removed;  // Dead ports the owning atomic no longer writes
+    std::vector<std::string> kept;     // Dead ports still written (logged, or model not prunable)
+
+    void print(std::ostream& out) const {
+        for (const auto& port : removed) {
+            out << "Dead port removed: " << port << std::endl;
+        }
+        for (const auto& port : kept) {
+            out << "Dead port kept: " << port << std::endl;
+        }
+    }
+};
+
+namespace detail {
+    struct PortGraph {
+        std::unordered_map<const PortInterface*, std::vector<const PortInterface*>> destinations;
+        std::unordered_set<const PortInterface*> inPorts;
+        std::vector<std::pair<std::string, std::shared_ptr<Component>>> atomics;
+
+        void walk(const std::shared_ptr<Component>& component, const std::string& path) {
+            for (const auto& port : component->getInPorts()) {
+                inPorts.insert(port.get());
+            }
+            auto coupled = std::dynamic_pointer_cast<Coupled>(component);
+            if (!coupled) {
+                atomics.emplace_back(path, component);
+                return;
+            }
+            for (const auto* couplings : {&coupled->getEICs(), &coupled->getICs(), &coupled->getEOCs()}) {
+                for (const auto& coupling : *couplings) {
+                    destinations[std::get<0>(coupling).get()].push_back(std::get<1>(coupling).get());
+                }
+            }
+            for (const auto& [id, child] : coupled->getComponents()) {
+                walk(child, path + "." + id);
+            }
+        }
+
+        // A port is live if its messages reach some input port, possibly through chains of EOCs.
+        bool live(const PortInterface* port) const {
+            auto it = destinations.find(port);
+            if (it == destinations.end()) {
+                return false;
+            }
+            return std::any_of(it->second.begin(), it->second.end(), [this](const PortInterface* to) {
+                return inPorts.count(to) != 0 || live(to);
+            });
+        }
+    };
+}
+
+// Finalization pass: finds atomic output ports whose messages can never reach an input port
+// and prunes them. A logger records every output port, so when one is attached (observed)
+// nothing is pruned and the dead ports are only reported.
+DeadPortReport eliminateDeadPorts(const std::shared_ptr<Coupled>& model, bool observed) {
+    detail::PortGraph graph;
+    graph.walk(model, model->getId());
+
+    DeadPortReport report;
+    for (const auto& [path, atomic] : graph.atomics) {
+        auto prunable = std::dynamic_pointer_cast<PrunableOutputs>(atomic);
+        for (const auto& port : atomic->getOutPorts()) {
+            if (graph.live(port.get())) {
+                continue;
+            }
+            std::string name = path + "." + port->getId();
+            if (observed) {
+                report.kept.push_back(name + " (logged)");
+            } else if (prunable) {
+                prunable->prune(port.get());
+                report.removed.push_back(name);
+            } else {
+                report.kept.push_back(name + " (model not prunable)");
+            }
+        }
+    }
+    std::sort(report.removed.begin(), report.removed.end());
+    std::sort(report.kept.begin(), report.kept.end());
+    return report;
+}
+
+#endif // DEADPORTELIMINATION_HPP
@@ -0,0 +1,54 @@
+#ifndef HEARTBEAT_HPP
+#define HEARTBEAT_HPP
+
+#include <functional>
+#include <iostream>
+#include <limits>
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "LogFilter.hpp"
+
+using namespace cadmium;
+
+struct HeartbeatState {
+    double sigma;
+    double clock;   // Simulation time of the last beat
+
+    explicit HeartbeatState(double period) : sigma(period), clock(0) {}
+};
+
+#ifndef NO_LOGGING
+std::ostream& operator<<(std::ostream &out, const HeartbeatState& state) {
+    out << "{" << state.sigma << ", clock: " << state.clock << "}";
+    return out;
+}
+#endif
+
+// Portless model that calls onBeat(simulationTime) every `period` time units. Used to observe a
+// running simulation (progress) without touching the models under test; its state is not logged.
+class Heartbeat : public Atomic<HeartbeatState> {
+public:
+    Heartbeat(const std::string& id, double period, std::function<void(double)> onBeat)
+        : Atomic<HeartbeatState>(id, HeartbeatState(period)), PERIOD(period), onBeat(std::move(onBeat)) {
+        excludeFromLog(id);
+    }
+
+    void internalTransition(HeartbeatState& state) const override {
+        state.clock += state.sigma;
+        state.sigma = PERIOD;
+        onBeat(state.clock);
+    }
+
+    void externalTransition(HeartbeatState& state, double e) const override {}
+
+    void output(const HeartbeatState& state) const override {}
+
+    [[nodiscard]] double timeAdvance(const HeartbeatState& state) const override {
+        return state.sigma;
+    }
+
+private:
+    const double PERIOD;
+    const std::function<void(double)> onBeat;
+};
+
+#endif // HEARTBEAT_HPP
@@ -0,0 +1,38 @@
+#ifndef LOGFILTER_HPP
+#define LOGFILTER_HPP
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+/*
+Models that drive or observe the simulation rather than belong to the rifle (the external input
+adapter, heartbeats) transition far more often than the models under test. They register their
+id with excludeFromLog(), and FilteredLogger drops their state lines so the log stays readable.
+Anything they put on an output port is still logged.
+*/
+
+std::unordered_set<std::string>& unloggedModels() {
+    static std::unordered_set<std::string> ids;
+    return ids;
+}
+
+inline void excludeFromLog(const std::string& id) {
+    unloggedModels().insert(id);
+}
+
+// Any Cadmium logger (STDOUTLogger, CSVLogger) minus the state lines of excluded models.
+template <typename L>
+class FilteredLogger : public L {
+public:
+    template <typename... Args>
+    explicit FilteredLogger(Args&&... args) : L(std::forward<Args>(args)...) {}
+
+    void logState(double time, long modelId, const std::string& modelName, const std::string& state) override {
+        if (unloggedModels().count(modelName) == 0) {
+            L::logState(time, modelId, modelName, state);
+        }
+    }
+};
+
+#endif // LOGFILTER_HPP
@@ -2,6 +2,7 @@
 #define MAGASSY_HPP
 
 #include "cadmium/modeling/devs/coupled.hpp"
+#include "MemoryAccounting.hpp"
 #include "Magazine.hpp"
 #include "Bullet.hpp"
 
@@ -17,6 +18,9 @@ public:
     Port<int> out_bulletReady;
     Port<int> out_isDud;
 
+    std::shared_ptr<Bullet> bullet;
+    std::shared_ptr<Magazine> magazine;
+
     // Constructor
     MagAssy(const std::string& id) : Coupled(id) {
         // Initialize ports
@@ -27,8 +31,8 @@ public:
         out_isDud = addOutPort<int>("out_isDud");
 
 
-        auto bullet = addComponent<Bullet>("Bullet");
-        auto magazine = addComponent<Magazine>("Magazine");
+        bullet = addAccountedComponent<Bullet>(*this, "Bullet");
+        magazine = addAccountedComponent<Magazine>(*this, "Magazine");
 
         addCoupling(this->in_initBullets, magazine->in_initBullets);
         addCoupling(this->in_initMagSeating, magazine->in_initMagSeating);
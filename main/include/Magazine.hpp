@@ -5,6 +5,10 @@
 #include <random>
 #include <iostream>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "DeadPortElimination.hpp"
+#include "MemoryAccounting.hpp"
+#include "ShotTrace.hpp"
+#include "RifleMetrics.hpp"
 
 using namespace cadmium;
 
@@ -13,8 +17,10 @@ struct MagazineState {
     States currentState;
     double sigma;
     int tempMsgVal, bulletsLeft, magSeating, bulletReady;
+    std::uint32_t shot;  // Traced shot whose feed triggered this update (SHOT_TRACE)
+    double clock;        // Simulation time of the last transition
 
-    explicit MagazineState(): sigma(1), currentState(States::PASSIVE), tempMsgVal(0), bulletsLeft(0), magSeating(0), bulletReady(0)  {
+    explicit constexpr MagazineState(): sigma(1), currentState(States::PASSIVE), tempMsgVal(0), bulletsLeft(0), magSeating(0), bulletReady(0), shot(0), clock(0)  {
     }
 };
 
@@ -25,7 +31,7 @@ std::ostream& operator<<(std::ostream &out, const MagazineState& state) {
 }
 #endif
 
-class Magazine : public Atomic<MagazineState> {
+class Magazine : public Atomic<MagazineState>, public PrunableOutputs, public AccountedModel {
     public:
 
     Port<int> in_initBullets;
@@ -43,6 +49,9 @@ class Magazine : public Atomic<MagazineState> {
 
 
     void internalTransition(MagazineState& state) const override {
+        auto scope = memScope();
+        state.clock += state.sigma;
+        countEvent(state.clock);
 
         state.currentState = MagazineState::States::PASSIVE;
         state.sigma = std::numeric_limits<double>::infinity();
@@ -50,8 +59,12 @@ class Magazine : public Atomic<MagazineState> {
 
  
     void externalTransition(MagazineState& state, double e) const override {
+        auto scope = memScope();
+        state.clock += e;
+        countEvent(state.clock);
 
         state.sigma -= e;
+        state.shot = 0;
         if(!in_initBullets->empty()){
             state.tempMsgVal = in_initBullets->getBag().back();
             if ((state.tempMsgVal >= 0) && (state.tempMsgVal<30)){
@@ -63,7 +76,8 @@ class Magazine : public Atomic<MagazineState> {
             state.magSeating =  state.tempMsgVal;
         }
         else if(!in_bulletLoaded->empty()){
-            state.tempMsgVal = in_bulletLoaded->getBag().back(); 
+            state.tempMsgVal = shotValue(in_bulletLoaded->getBag().back());
+            state.shot = shotOf(in_bulletLoaded->getBag().back());
             if(state.tempMsgVal == 1){
                 state.bulletsLeft--;
             }
@@ -82,15 +96,21 @@ class Magazine : public Atomic<MagazineState> {
     
     // output function
     void output(const MagazineState& state) const override {
+        auto scope = memScope();
        
         
-        out_bulletReady->addMessage(state.bulletReady);
+        if (live(out_bulletReady)) {
+            out_bulletReady->addMessage(tagShot(state.bulletReady, state.shot));
+        }
     }
 
     // time_advance function
     [[nodiscard]] double timeAdvance(const MagazineState& state) const override {     
             return state.sigma;
     }
+
+    [[nodiscard]] const MagazineState& getState() const { return state; }
+    void setState(const MagazineState& snapshot) { state = snapshot; }
 };
 
 #endif
@@ -0,0 +1,240 @@
+#ifndef MEMORYACCOUNTING_HPP
+#define MEMORYACCOUNTING_HPP
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "cadmium/modeling/devs/coupled.hpp"
+
+/*
+Heap accounting (enabled with MEM_ACCOUNTING).
+
+The global operator new/delete are replaced so that every allocation is charged to the
+innermost open MemScope of the allocating thread (or to the "process" root). Each block carries
+a small header naming its scope, so a free is credited back to the scope that allocated it even
+when it happens later, elsewhere. Scopes with the same name under the same parent are merged,
+which turns them into a per-component tree when coupled models add their children through
+addAccountedComponent().
+
+Models that derive from AccountedModel also open a scope in their transitions and output. The scope
+mirrors their construction scope under "simulation" (top/rifle/Chbr -> simulation/top/rifle/Chbr),
+so steady-state allocations such as message bag growth in output() are charged per component.
+
+Scopes are opened from the simulation thread; other threads (input reader, metrics exporter)
+are charged to the root. The replacement operators are defined here, so this header must be
+included by exactly one translation unit, like the rest of the models.
+
+Without MEM_ACCOUNTING, MemScope and AccountedModel are empty and addAccountedComponent() is a plain
+addComponent().
+*/
+
+#ifdef MEM_ACCOUNTING
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <new>
+
+struct MemNode {
+    char name[40];
+    MemNode* parent;
+    MemNode* firstChild;
+    MemNode* nextSibling;
+    std::atomic<std::int64_t> liveBytes {0};
+    std::atomic<std::uint64_t> allocatedBytes {0};
+    std::atomic<std::uint64_t> allocations {0};
+
+    MemNode(const char* id, MemNode* parent) : name(), parent(parent), firstChild(nullptr), nextSibling(nullptr) {
+        std::strncpy(name, id, sizeof(name) - 1);
+    }
+};
+
+namespace memacct {
+    // Header in front of every block; 16 bytes keeps the block aligned for any fundamental type.
+    struct alignas(16) BlockHeader {
+        MemNode* node;
+        std::size_t size;
+    };
+
+    // Nodes are carved from malloc directly so that building the tree is never itself accounted.
+    inline MemNode* makeNode(const char* id, MemNode* parent) {
+        return new (std::malloc(sizeof(MemNode))) MemNode(id, parent);
+    }
+
+    inline MemNode& root() {
+        static MemNode* node = makeNode("process", nullptr);
+        return *node;
+    }
+
+    inline thread_local MemNode* current = nullptr;
+    inline std::atomic<std::int64_t> liveBytes {0};
+    inline std::atomic<std::int64_t> peakBytes {0};
+
+    inline MemNode* child(MemNode* parent, const char* id) {
+        MemNode** link = &parent->firstChild;
+        for (; *link != nullptr; link = &(*link)->nextSibling) {
+            if (std::strncmp((*link)->name, id, sizeof((*link)->name) - 1) == 0) {
+                return *link;
+            }
+        }
+        *link = makeNode(id, parent);
+        return *link;
+    }
+
+    // Copy of a construction scope's path under the "simulation" scope.
+    inline MemNode* simulationNode(MemNode* node) {
+        if (node == nullptr || node == &root()) {
+            return child(&root(), "simulation");
+        }
+        return child(simulationNode(node->parent), node->name);
+    }
+
+    inline void* allocate(std::size_t size) {
+        auto* header = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + size));
+        if (header == nullptr) {
+            return nullptr;
+        }
+        MemNode* node = current != nullptr ? current : &root();
+        header->node = node;
+        header->size = size;
+        node->liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        node->allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        node->allocations.fetch_add(1, std::memory_order_relaxed);
+        std::int64_t live = liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) + static_cast<std::int64_t>(size);
+        std::int64_t peak = peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        return header + 1;
+    }
+
+    inline void release(void* block) {
+        if (block == nullptr) {
+            return;
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+        header->node->liveBytes.fetch_sub(static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+        liveBytes.fetch_sub(static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+        std::free(header);
+    }
+
+    inline void* allocateOrThrow(std::size_t size) {
+        void* block = allocate(size);
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+
+    struct Totals {
+        std::int64_t live = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t count = 0;
+    };
+
+    inline Totals totals(const MemNode& node) {
+        Totals sum {node.liveBytes.load(), node.allocatedBytes.load(), node.allocations.load()};
+        for (const MemNode* c = node.firstChild; c != nullptr; c = c->nextSibling) {
+            Totals sub = totals(*c);
+            sum.live += sub.live;
+            sum.bytes += sub.bytes;
+            sum.count += sub.count;
+        }
+        return sum;
+    }
+
+    inline void print(std::ostream& out, const MemNode& node, int depth) {
+        Totals sum = totals(node);
+        out << std::string(2 * depth, ' ') << std::left << std::setw(32 - 2 * depth) << node.name << std::right
+            << std::setw(12) << sum.live << std::setw(14) << sum.bytes << std::setw(10) << sum.count << "\n";
+        for (const MemNode* c = node.firstChild; c != nullptr; c = c->nextSibling) {
+            print(out, *c, depth + 1);
+        }
+    }
+}
+
+// Replacement allocation functions (aligned overloads keep their default malloc/free pairing).
+void* operator new(std::size_t size) { return memacct::allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return memacct::allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return memacct::allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return memacct::allocate(size); }
+void operator delete(void* block) noexcept { memacct::release(block); }
+void operator delete[](void* block) noexcept { memacct::release(block); }
+void operator delete(void* block, std::size_t) noexcept { memacct::release(block); }
+void operator delete[](void* block, std::size_t) noexcept { memacct::release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { memacct::release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { memacct::release(block); }
+
+// Charges allocations made while it is alive to a child scope `name` of the current scope.
+class MemScope {
+public:
+    explicit MemScope(const std::string& name) : previous(memacct::current) {
+        memacct::current = memacct::child(previous != nullptr ? previous : &memacct::root(), name.c_str());
+    }
+    explicit MemScope(MemNode* node) : previous(memacct::current) {
+        memacct::current = node;
+    }
+    ~MemScope() { memacct::current = previous; }
+
+    MemScope(const MemScope&) = delete;
+    MemScope& operator=(const MemScope&) = delete;
+
+private:
+    MemNode* previous;
+};
+
+// Mixin for atomics: `auto scope = memScope();` at the top of a transition or output charges what it
+// allocates to the component. The node is resolved once, while the component is being constructed.
+class AccountedModel {
+public:
+    virtual ~AccountedModel() = default;
+
+protected:
+    AccountedModel() : simulationScope(memacct::simulationNode(memacct::current)) {}
+
+    [[nodiscard]] MemScope memScope() const {
+        return MemScope(simulationScope);
+    }
+
+private:
+    MemNode* simulationScope;
+};
+
+// Per-scope tree (inclusive of children) followed by the process-wide peak.
+void printMemoryReport(std::ostream& out) {
+    out << std::left << std::setw(32) << "Memory scope" << std::right
+        << std::setw(12) << "live B" << std::setw(14) << "allocated B" << std::setw(10) << "allocs" << "\n";
+    memacct::print(out, memacct::root(), 0);
+    out << "Process heap: " << memacct::liveBytes.load() << " B live, " << memacct::peakBytes.load() << " B peak" << std::endl;
+}
+
+#else
+
+class MemScope {
+public:
+    MemScope() = default;
+    explicit MemScope(const std::string&) {}
+    ~MemScope() {}  // User-provided so `auto scope = ...` is not flagged as unused
+};
+
+class AccountedModel {
+public:
+    virtual ~AccountedModel() = default;
+
+protected:
+    [[nodiscard]] MemScope memScope() const {
+        return MemScope();
+    }
+};
+
+#endif // MEM_ACCOUNTING
+
+// addComponent() with the child's construction charged to a scope named after its id.
+template <typename T, typename... Args>
+std::shared_ptr<T> addAccountedComponent(cadmium::Coupled& parent, const std::string& id, Args&&... args) {
+    MemScope scope(id);
+    return parent.addComponent<T>(id, std::forward<Args>(args)...);
+}
+
+#endif // MEMORYACCOUNTING_HPP
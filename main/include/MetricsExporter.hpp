@@ -0,0 +1,161 @@
+#ifndef METRICSEXPORTER_HPP
+#define METRICSEXPORTER_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "RifleMetrics.hpp"
+
+/*
+Serves RifleMetrics in the Prometheus text format from a background thread:
+
+    curl -s localhost:9464/metrics
+
+`endpoint` is a TCP port on 127.0.0.1, or a path (starting with '/') for a UNIX socket
+(curl --unix-socket <path> localhost/metrics). Every request gets the same plain-text page;
+the thread only reads the atomics, so the simulation thread is never blocked by a scrape.
+*/
+class MetricsExporter {
+public:
+    explicit MetricsExporter(const std::string& endpoint = "9464") : listenFd(-1), running(true), unixPath() {
+        listenFd = listen(endpoint);
+        if (listenFd < 0) {
+            std::cerr << "[MetricsExporter] cannot listen on '" << endpoint << "': " << std::strerror(errno) << std::endl;
+            return;
+        }
+        server = std::thread([this] { serve(); });
+    }
+
+    ~MetricsExporter() {
+        running.store(false, std::memory_order_relaxed);
+        if (server.joinable()) {
+            server.join();
+        }
+        if (listenFd >= 0) {
+            ::close(listenFd);
+        }
+        if (!unixPath.empty()) {
+            ::unlink(unixPath.c_str());
+        }
+    }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Scrape page for the current counter values. Nothing depends on earlier scrapes, so any number
+    // of scrapers see consistent values; they can derive windowed rates from rifle_events_total.
+    static std::string render(const RifleMetrics& metrics) {
+        const double wall = (RifleMetrics::nowNs() - metrics.wallStartNs.load(std::memory_order_relaxed)) / 1e9;
+        const MetricCount events = metrics.events.load(std::memory_order_relaxed);
+        std::ostringstream out;
+        auto metric = [&out](const char* name, const char* type, const char* help, auto value) {
+            out << "# HELP " << name << " " << help << "\n"
+                << "# TYPE " << name << " " << type << "\n"
+                << name << " " << value << "\n";
+        };
+        metric("rifle_events_total", "counter", "Atomic model transitions.", events);
+        metric("rifle_events_per_second", "gauge", "Average transition rate since the simulation started.", wall > 0 ? events / wall : 0.0);
+        metric("rifle_sim_time_seconds", "gauge", "Simulation time of the latest model transition.", metrics.simTime.load(std::memory_order_relaxed));
+        metric("rifle_wall_time_seconds", "gauge", "Wall time since the simulation started.", wall);
+        metric("rifle_rounds_fired_total", "counter", "Rounds fired.", metrics.roundsFired.load(std::memory_order_relaxed));
+        metric("rifle_jams_total", "counter", "Bullets that failed to load.", metrics.jams.load(std::memory_order_relaxed));
+        metric("rifle_duds_total", "counter", "Dud rounds.", metrics.duds.load(std::memory_order_relaxed));
+        metric("rifle_rt_lateness_seconds", "gauge", "Real-time lateness at the last sample (every 64 events).", metrics.latenessNs.load(std::memory_order_relaxed) / 1e9);
+        metric("rifle_rt_lateness_max_seconds", "gauge", "Largest real-time lateness seen.", metrics.maxLatenessNs.load(std::memory_order_relaxed) / 1e9);
+        return out.str();
+    }
+
+private:
+    int listenFd;
+    std::atomic<bool> running;
+    std::string unixPath;
+    std::thread server;
+
+    int listen(const std::string& endpoint) {
+        int fd;
+        if (!endpoint.empty() && endpoint[0] == '/') {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr {};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, endpoint.c_str(), sizeof(addr.sun_path) - 1);
+            ::unlink(endpoint.c_str());
+            if (fd < 0 || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                return closeOnError(fd);
+            }
+            unixPath = endpoint;
+        } else {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            sockaddr_in addr {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<std::uint16_t>(std::atoi(endpoint.c_str())));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (fd < 0 || ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+                || ::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                return closeOnError(fd);
+            }
+        }
+        if (::listen(fd, 4) != 0) {
+            return closeOnError(fd);
+        }
+        return fd;
+    }
+
+    static int closeOnError(int fd) {
+        int error = errno;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        errno = error;
+        return -1;
+    }
+
+    void serve() {
+        pollfd pfd {listenFd, POLLIN, 0};
+        while (running.load(std::memory_order_relaxed)) {
+            // Poll timeout only bounds shutdown
+            if (::poll(&pfd, 1, 100) <= 0) {
+                continue;
+            }
+            int client = ::accept(listenFd, nullptr, nullptr);
+            if (client < 0) {
+                continue;
+            }
+            // The request itself is irrelevant; drain what has arrived so the client sees a clean close.
+            char request[1024];
+            pollfd cfd {client, POLLIN, 0};
+            if (::poll(&cfd, 1, 100) > 0) {
+                (void) ::recv(client, request, sizeof(request), 0);
+            }
+
+            const std::string body = render(rifleMetrics());
+            const std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+            std::size_t sent = 0;
+            while (sent < response.size()) {
+                ssize_t n = ::send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    break;
+                }
+                sent += static_cast<std::size_t>(n);
+            }
+            ::close(client);
+        }
+    }
+};
+
+#endif // METRICSEXPORTER_HPP
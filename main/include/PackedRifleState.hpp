@@ -0,0 +1,414 @@
+#ifndef PACKEDRIFLESTATE_HPP
+#define PACKEDRIFLESTATE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include "Rifle.hpp"
+
+/*
+Bit-packed encoding of the rifle atomics' states: one 64-bit word plus one time value.
+
+Every sigma the models set is 0, 1 or infinity, except Chamber's firing delay. Each sigma is
+therefore stored as a 2-bit code, with the escape code pointing at the shared `time` slot. All
+atomics that escape in one packed value must share that time; otherwise packing fails. Flags
+and enums take 1-2 bits; Magazine's counters take signed bytes.
+
+Packing is lossless for every representable state. pack*() returns nullopt when a field is out
+of range instead of truncating it. The static_asserts at the end of this file check the round
+trip over every field's encodable range. Bookkeeping fields are not encoded and unpack as 0: the
+trace shot ID (SHOT_TRACE) and each atomic's clock.
+
+This is a state-only encoding, for hashing, visited-state sets and comparing runs. It is not a
+checkpoint format. It records no elapsed time or next-event time per atomic, and setState() on a
+running model does not reschedule it with the coordinator. Restoring a Chamber that is 2 units
+into its 5.0 firing delay would start a fresh 5.0 delay.
+
+Layout, from bit 0: TrigAssy (6) | BoltAssy (7) | Chamber (6) | Magazine (21) | Bullet (5) = 45 bits.
+*/
+
+struct PackedState {
+    std::uint64_t bits = 0;
+    double time = 0;    // Value of the escaped sigma, 0 when no sigma escapes
+
+    bool operator==(const PackedState& other) const {
+        return bits == other.bits && std::memcmp(&time, &other.time, sizeof(time)) == 0;
+    }
+};
+
+namespace packing {
+    constexpr unsigned TRIG_BITS = 6;
+    constexpr unsigned BOLT_BITS = 7;
+    constexpr unsigned CHAMBER_BITS = 6;
+    constexpr unsigned MAGAZINE_BITS = 21;
+    constexpr unsigned BULLET_BITS = 5;
+    static_assert(TRIG_BITS + BOLT_BITS + CHAMBER_BITS + MAGAZINE_BITS + BULLET_BITS <= 64, "Rifle must fit one word");
+
+    enum SigmaCode : unsigned {SIGMA_ZERO, SIGMA_ONE, SIGMA_INFINITY, SIGMA_TIME};
+
+    class Writer {
+    public:
+        constexpr void put(unsigned width, int value) {
+            ok = ok && value >= 0 && static_cast<std::uint64_t>(value) < (std::uint64_t{1} << width);
+            append(width, static_cast<std::uint64_t>(value));
+        }
+
+        constexpr void putSigned(unsigned width, int value) {
+            const int limit = 1 << (width - 1);
+            ok = ok && value >= -limit && value < limit;
+            append(width, static_cast<std::uint64_t>(value) & ((std::uint64_t{1} << width) - 1));
+        }
+
+        template <typename E>
+        constexpr void putEnum(E value) {
+            put(1, static_cast<int>(value));
+        }
+
+        constexpr void putSigma(double sigma) {
+            if (sigma == 0.0) {
+                append(2, SIGMA_ZERO);
+            } else if (sigma == 1.0) {
+                append(2, SIGMA_ONE);
+            } else if (sigma == std::numeric_limits<double>::infinity()) {
+                append(2, SIGMA_INFINITY);
+            } else {
+                ok = ok && (!timeUsed || packed.time == sigma);
+                timeUsed = true;
+                packed.time = sigma;
+                append(2, SIGMA_TIME);
+            }
+        }
+
+        [[nodiscard]] constexpr std::optional<PackedState> result() const {
+            return ok ? std::optional<PackedState>(packed) : std::nullopt;
+        }
+
+    private:
+        PackedState packed;
+        unsigned position = 0;
+        bool ok = true;
+        bool timeUsed = false;
+
+        constexpr void append(unsigned width, std::uint64_t value) {
+            packed.bits |= value << position;
+            position += width;
+        }
+    };
+
+    class Reader {
+    public:
+        constexpr explicit Reader(const PackedState& packed) : packed(packed) {}
+
+        constexpr int get(unsigned width) {
+            auto value = static_cast<int>((packed.bits >> position) & ((std::uint64_t{1} << width) - 1));
+            position += width;
+            return value;
+        }
+
+        constexpr int getSigned(unsigned width) {
+            int value = get(width);
+            return value >= (1 << (width - 1)) ? value - (1 << width) : value;
+        }
+
+        template <typename E>
+        constexpr E getEnum() {
+            return static_cast<E>(get(1));
+        }
+
+        constexpr double getSigma() {
+            switch (get(2)) {
+                case SIGMA_ZERO: return 0.0;
+                case SIGMA_ONE: return 1.0;
+                case SIGMA_INFINITY: return std::numeric_limits<double>::infinity();
+                default: return packed.time;
+            }
+        }
+
+    private:
+        const PackedState& packed;
+        unsigned position = 0;
+    };
+
+    // ---- Per-atomic field layouts; write() and read() must list fields in the same order.
+
+    constexpr void write(Writer& w, const TrigAssyState& s) {
+        w.putSigma(s.sigma);
+        w.putEnum(s.currentState);
+        w.put(1, s.triggerPull);
+        w.put(2, s.firingSelector);
+    }
+
+    constexpr void read(Reader& r, TrigAssyState& s) {
+        s.sigma = r.getSigma();
+        s.currentState = r.getEnum<TrigAssyState::States>();
+        s.triggerPull = r.get(1);
+        s.firingSelector = r.get(2);
+        s.clock = 0;
+    }
+
+    constexpr void write(Writer& w, const BoltAssyState& s) {
+        w.putSigma(s.sigma);
+        w.putEnum(s.currentState);
+        w.put(0, s.tempMsgVal);  // Never written by the model; must stay 0
+        w.put(1, s.boltFree);
+        w.put(1, s.readyBullet);
+        w.put(2, s.boltState);
+    }
+
+    constexpr void read(Reader& r, BoltAssyState& s) {
+        s.sigma = r.getSigma();
+        s.currentState = r.getEnum<BoltAssyState::States>();
+        s.tempMsgVal = 0;
+        s.boltFree = r.get(1);
+        s.readyBullet = r.get(1);
+        s.boltState = r.get(2);
+        s.shot = 0;
+        s.clock = 0;
+    }
+
+    constexpr void write(Writer& w, const ChamberState& s) {
+        w.putSigma(s.sigma);
+        w.putEnum(s.currentState);
+        w.put(2, s.dudBullet);
+        w.put(1, s.bulletIn);
+    }
+
+    constexpr void read(Reader& r, ChamberState& s) {
+        s.sigma = r.getSigma();
+        s.currentState = r.getEnum<ChamberState::States>();
+        s.dudBullet = r.get(2);
+        s.bulletIn = r.get(1);
+        s.shot = 0;
+        s.clock = 0;
+    }
+
+    constexpr void write(Writer& w, const MagazineState& s) {
+        w.putSigma(s.sigma);
+        w.putEnum(s.currentState);
+        w.putSigned(8, s.tempMsgVal);
+        w.putSigned(8, s.bulletsLeft);
+        w.put(1, s.magSeating);
+        w.put(1, s.bulletReady);
+    }
+
+    constexpr void read(Reader& r, MagazineState& s) {
+        s.sigma = r.getSigma();
+        s.currentState = r.getEnum<MagazineState::States>();
+        s.tempMsgVal = r.getSigned(8);
+        s.bulletsLeft = r.getSigned(8);
+        s.magSeating = r.get(1);
+        s.bulletReady = r.get(1);
+        s.shot = 0;
+        s.clock = 0;
+    }
+
+    constexpr void write(Writer& w, const BulletState& s) {
+        w.putSigma(s.sigma);
+        w.putEnum(s.currentState);
+        w.put(1, s.bulletRdy);
+        w.put(1, s.isDud);
+    }
+
+    constexpr void read(Reader& r, BulletState& s) {
+        s.sigma = r.getSigma();
+        s.currentState = r.getEnum<BulletState::States>();
+        s.bulletRdy = r.get(1);
+        s.isDud = r.get(1);
+        s.shot = 0;
+        s.clock = 0;
+    }
+
+    // Whole-rifle layout, in the order given at the top of this file.
+    struct RifleStates {
+        TrigAssyState trig;
+        BoltAssyState bolt;
+        ChamberState chamber;
+        MagazineState magazine;
+        BulletState bullet;
+    };
+
+    constexpr void write(Writer& w, const RifleStates& s) {
+        write(w, s.trig);
+        write(w, s.bolt);
+        write(w, s.chamber);
+        write(w, s.magazine);
+        write(w, s.bullet);
+    }
+
+    constexpr void read(Reader& r, RifleStates& s) {
+        read(r, s.trig);
+        read(r, s.bolt);
+        read(r, s.chamber);
+        read(r, s.magazine);
+        read(r, s.bullet);
+    }
+}
+
+// Single atomic state, e.g. packState(boltState). nullopt if a field does not fit.
+template <typename S>
+constexpr std::optional<PackedState> packState(const S& state) {
+    packing::Writer writer;
+    packing::write(writer, state);
+    return writer.result();
+}
+
+template <typename S>
+constexpr S unpackState(const PackedState& packed) {
+    S state;
+    packing::Reader reader(packed);
+    packing::read(reader, state);
+    return state;
+}
+
+// Whole rifle: every atomic in one word plus the shared escaped sigma.
+std::optional<PackedState> packRifle(const Rifle& rifle) {
+    return packState(packing::RifleStates {
+        rifle.trig->getState(),
+        rifle.bolt->getState(),
+        rifle.chamber->getState(),
+        rifle.magAssy->magazine->getState(),
+        rifle.magAssy->bullet->getState(),
+    });
+}
+
+// Sets the models' state variables only; see the top of this file for why this is not a restore.
+void unpackRifle(const PackedState& packed, Rifle& rifle) {
+    auto states = unpackState<packing::RifleStates>(packed);
+    rifle.trig->setState(states.trig);
+    rifle.bolt->setState(states.bolt);
+    rifle.chamber->setState(states.chamber);
+    rifle.magAssy->magazine->setState(states.magazine);
+    rifle.magAssy->bullet->setState(states.bullet);
+}
+
+// 64-bit hash of a packed state (splitmix64 finalizer over both words), e.g. for visited-state sets.
+constexpr std::uint64_t hashPacked(std::uint64_t bits, std::uint64_t timeBits) {
+    std::uint64_t x = bits ^ (timeBits + 0x9e3779b97f4a7c15ULL + (bits << 6) + (bits >> 2));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+inline std::uint64_t hashPacked(const PackedState& packed) {
+    std::uint64_t timeBits;
+    std::memcpy(&timeBits, &packed.time, sizeof(timeBits));
+    return hashPacked(packed.bits, timeBits);
+}
+
+// ---- Compile-time round-trip checks: every field is swept over its encodable range with the
+// others at their defaults, every sigma code is tried, and out-of-range values must be refused.
+
+namespace packing::check {
+    constexpr bool same(const TrigAssyState& a, const TrigAssyState& b) {
+        return a.sigma == b.sigma && a.currentState == b.currentState && a.triggerPull == b.triggerPull
+            && a.firingSelector == b.firingSelector;
+    }
+
+    constexpr bool same(const BoltAssyState& a, const BoltAssyState& b) {
+        return a.sigma == b.sigma && a.currentState == b.currentState && a.tempMsgVal == b.tempMsgVal
+            && a.boltFree == b.boltFree && a.readyBullet == b.readyBullet && a.boltState == b.boltState;
+    }
+
+    constexpr bool same(const ChamberState& a, const ChamberState& b) {
+        return a.sigma == b.sigma && a.currentState == b.currentState && a.dudBullet == b.dudBullet
+            && a.bulletIn == b.bulletIn;
+    }
+
+    constexpr bool same(const MagazineState& a, const MagazineState& b) {
+        return a.sigma == b.sigma && a.currentState == b.currentState && a.tempMsgVal == b.tempMsgVal
+            && a.bulletsLeft == b.bulletsLeft && a.magSeating == b.magSeating && a.bulletReady == b.bulletReady;
+    }
+
+    constexpr bool same(const BulletState& a, const BulletState& b) {
+        return a.sigma == b.sigma && a.currentState == b.currentState && a.bulletRdy == b.bulletRdy
+            && a.isDud == b.isDud;
+    }
+
+    constexpr bool same(const RifleStates& a, const RifleStates& b) {
+        return same(a.trig, b.trig) && same(a.bolt, b.bolt) && same(a.chamber, b.chamber)
+            && same(a.magazine, b.magazine) && same(a.bullet, b.bullet);
+    }
+
+    template <typename S>
+    constexpr bool roundTrips(const S& state) {
+        auto packed = packState(state);
+        return packed.has_value() && same(unpackState<S>(*packed), state);
+    }
+
+    // set(state, v) for every v in [from, to] must round-trip.
+    template <typename S, typename Set>
+    constexpr bool sweep(int from, int to, Set set) {
+        for (int v = from; v <= to; ++v) {
+            S state;
+            set(state, v);
+            if (!roundTrips(state)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename S, typename Set>
+    constexpr bool refused(int value, Set set) {
+        S state;
+        set(state, value);
+        return !packState(state).has_value();
+    }
+
+    template <typename S>
+    constexpr bool sigmas() {
+        for (double sigma : {0.0, 1.0, std::numeric_limits<double>::infinity(), 5.0, 0.25}) {
+            for (auto current : {S::States::PASSIVE, S::States::ACTIVE}) {
+                S state;
+                state.sigma = sigma;
+                state.currentState = current;
+                if (!roundTrips(state)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Two escaped sigmas share the time slot only when they are equal.
+    constexpr bool sharedTime() {
+        RifleStates same;
+        same.chamber.sigma = 5.0;
+        same.magazine.sigma = 5.0;
+        RifleStates clash = same;
+        clash.magazine.sigma = 2.0;
+        return roundTrips(same) && !packState(clash).has_value();
+    }
+}
+
+static_assert(packing::check::sigmas<TrigAssyState>() && packing::check::sigmas<BoltAssyState>()
+              && packing::check::sigmas<ChamberState>() && packing::check::sigmas<MagazineState>()
+              && packing::check::sigmas<BulletState>(), "Every sigma code must round-trip");
+static_assert(packing::check::sweep<TrigAssyState>(0, 1, [](TrigAssyState& s, int v) { s.triggerPull = v; })
+              && packing::check::sweep<TrigAssyState>(0, 3, [](TrigAssyState& s, int v) { s.firingSelector = v; })
+              && packing::check::refused<TrigAssyState>(4, [](TrigAssyState& s, int v) { s.firingSelector = v; }),
+              "TrigAssy fields must round-trip");
+static_assert(packing::check::sweep<BoltAssyState>(0, 1, [](BoltAssyState& s, int v) { s.boltFree = v; })
+              && packing::check::sweep<BoltAssyState>(0, 1, [](BoltAssyState& s, int v) { s.readyBullet = v; })
+              && packing::check::sweep<BoltAssyState>(0, 3, [](BoltAssyState& s, int v) { s.boltState = v; })
+              && packing::check::refused<BoltAssyState>(1, [](BoltAssyState& s, int v) { s.tempMsgVal = v; })
+              && packing::check::refused<BoltAssyState>(4, [](BoltAssyState& s, int v) { s.boltState = v; }),
+              "BoltAssy fields must round-trip");
+static_assert(packing::check::sweep<ChamberState>(0, 3, [](ChamberState& s, int v) { s.dudBullet = v; })
+              && packing::check::sweep<ChamberState>(0, 1, [](ChamberState& s, int v) { s.bulletIn = v; })
+              && packing::check::refused<ChamberState>(2, [](ChamberState& s, int v) { s.bulletIn = v; }),
+              "Chamber fields must round-trip");
+static_assert(packing::check::sweep<MagazineState>(-128, 127, [](MagazineState& s, int v) { s.tempMsgVal = v; })
+              && packing::check::sweep<MagazineState>(-128, 127, [](MagazineState& s, int v) { s.bulletsLeft = v; })
+              && packing::check::sweep<MagazineState>(0, 1, [](MagazineState& s, int v) { s.magSeating = v; })
+              && packing::check::sweep<MagazineState>(0, 1, [](MagazineState& s, int v) { s.bulletReady = v; })
+              && packing::check::refused<MagazineState>(128, [](MagazineState& s, int v) { s.bulletsLeft = v; })
+              && packing::check::refused<MagazineState>(-129, [](MagazineState& s, int v) { s.tempMsgVal = v; }),
+              "Magazine fields must round-trip");
+static_assert(packing::check::sweep<BulletState>(0, 1, [](BulletState& s, int v) { s.bulletRdy = v; })
+              && packing::check::sweep<BulletState>(0, 1, [](BulletState& s, int v) { s.isDud = v; }),
+              "Bullet fields must round-trip");
+static_assert(packing::check::sharedTime(), "Escaped sigmas must share one time value");
+
+#endif // PACKEDRIFLESTATE_HPP
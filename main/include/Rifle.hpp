@@ -3,6 +3,7 @@
 
 #include <string>
 #include "cadmium/modeling/devs/coupled.hpp"
+#include "MemoryAccounting.hpp"
 #include "MagAssy.hpp"
 #include "TrigAssy.hpp"
 #include "BoltAssy.hpp"
@@ -20,6 +21,12 @@ public:
     Port<int> in_magSeating;
     Port<int> in_bulletLoaded;
     Port<int> out_releaseBolt;
+
+    std::shared_ptr<MagAssy> magAssy;
+    std::shared_ptr<TrigAssy> trig;
+    std::shared_ptr<BoltAssy> bolt;
+    std::shared_ptr<Chamber> chamber;
+
     Rifle(const std::string& id) 
         : Coupled(id)
     {
@@ -30,10 +37,10 @@ public:
         in_bulletLoaded = addInPort<int>("in_bulletLoaded");
         out_releaseBolt = addOutPort<int>("out_releaseBolt");
 
-        auto magAssy = addComponent<MagAssy>("MagAssy");
-        auto trig    = addComponent<TrigAssy>("TA");
-        auto bolt    = addComponent<BoltAssy>("BA");
-        auto chamber = addComponent<Chamber>("Chbr");
+        magAssy = addAccountedComponent<MagAssy>(*this, "MagAssy");
+        trig    = addAccountedComponent<TrigAssy>(*this, "TA");
+        bolt    = addAccountedComponent<BoltAssy>(*this, "BA");
+        chamber = addAccountedComponent<Chamber>(*this, "Chbr");
 
         // Internal Couplings
         addCoupling(magAssy->out_bulletReady, bolt->in_bulletReady);
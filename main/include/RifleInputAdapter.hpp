@@ -0,0 +1,375 @@
+#ifndef RIFLEINPUTADAPTER_HPP
+#define RIFLEINPUTADAPTER_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "SpscQueue.hpp"
+#include "LogFilter.hpp"
+
+using namespace cadmium;
+
+/*
+External input for real-time runs. A reader thread takes text lines of the form
+
+    [time] trigger|selector <value>
+
+from a file descriptor (stdin, a named pipe, a regular file or a UNIX stream socket)
+and hands them to the simulation through a lock-free single-producer queue.
+`time` is in simulation seconds since start; when omitted or negative the event is
+injected as soon as it is seen.
+*/
+
+struct ExternalInputEvent {
+    enum class Target : std::uint8_t {TRIGGER, SELECTOR};
+    double time;                 // Requested injection time (< 0 = immediately)
+    bool timed;                  // The line gave a time
+    Target target;
+    int value;
+    std::int64_t receivedNs;     // steady_clock stamp taken by the reader thread
+};
+
+// Owns the reader thread and the queue it fills. One source per producer.
+class ExternalInputSource {
+public:
+    static constexpr std::size_t QUEUE_SIZE = 1024;
+
+    // path: "-" or empty for stdin, otherwise a FIFO, regular file or UNIX socket.
+    explicit ExternalInputSource(const std::string& path) : fd(-1), ownsFd(false), running(true), dropped(0), rejected(0) {
+        fd = openInput(path);
+        ownsFd = fd > STDERR_FILENO;
+        if (fd < 0) {
+            std::cerr << "[RifleInputAdapter] cannot open input '" << path << "': " << std::strerror(errno) << std::endl;
+            return;
+        }
+        reader = std::thread([this] { readLoop(); });
+    }
+
+    ~ExternalInputSource() {
+        running.store(false, std::memory_order_relaxed);
+        if (reader.joinable()) {
+            reader.join();
+        }
+        if (ownsFd) {
+            ::close(fd);
+        }
+    }
+
+    ExternalInputSource(const ExternalInputSource&) = delete;
+    ExternalInputSource& operator=(const ExternalInputSource&) = delete;
+
+    bool pop(ExternalInputEvent& event) { return queue.tryPop(event); }
+
+    [[nodiscard]] std::uint64_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t rejectedLines() const { return rejected.load(std::memory_order_relaxed); }
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Parses one input line. Returns false for blank or malformed lines.
+    static bool parse(const std::string& line, ExternalInputEvent& event) {
+        std::istringstream in(line);
+        std::vector<std::string> tokens;
+        for (std::string token; in >> token;) {
+            tokens.push_back(token);
+        }
+        if (tokens.size() < 2 || tokens.size() > 3) {
+            return false;
+        }
+        try {
+            event.time = tokens.size() == 3 ? std::stod(tokens[0]) : -1.0;
+            event.timed = event.time >= 0;
+            event.value = std::stoi(tokens.back());
+        } catch (const std::exception&) {
+            return false;
+        }
+        const std::string& target = tokens[tokens.size() - 2];
+        if (target == "trigger") {
+            event.target = ExternalInputEvent::Target::TRIGGER;
+        } else if (target == "selector") {
+            event.target = ExternalInputEvent::Target::SELECTOR;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    SpscQueue<ExternalInputEvent, QUEUE_SIZE> queue;
+    std::thread reader;
+    int fd;
+    bool ownsFd;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<std::uint64_t> rejected;
+
+    static int openInput(const std::string& path) {
+        if (path.empty() || path == "-") {
+            return STDIN_FILENO;
+        }
+        struct stat info {};
+        if (::stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            int sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un addr {};
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            if (sock >= 0 && ::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+                return sock;
+            }
+            if (sock >= 0) {
+                ::close(sock);
+            }
+            return -1;
+        }
+        // Non-blocking open so that a FIFO without a writer does not stall start-up.
+        return ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    }
+
+    void readLoop() {
+        std::string pending;
+        char buffer[512];
+        pollfd pfd {fd, POLLIN, 0};
+        while (running.load(std::memory_order_relaxed)) {
+            // Short poll timeout only bounds shutdown; events wake the thread immediately.
+            if (::poll(&pfd, 1, 50) <= 0) {
+                continue;
+            }
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+                    continue;
+                }
+                // EOF: a FIFO may be reopened by a new writer, anything else is finished.
+                struct stat info {};
+                if (::fstat(fd, &info) == 0 && S_ISFIFO(info.st_mode)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    continue;
+                }
+                break;
+            }
+            const std::int64_t stamp = nowNs();
+            pending.append(buffer, static_cast<std::size_t>(n));
+            std::size_t start = 0;
+            for (std::size_t eol; (eol = pending.find('\n', start)) != std::string::npos; start = eol + 1) {
+                ExternalInputEvent event {};
+                if (!parse(pending.substr(start, eol - start), event)) {
+                    rejected.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                event.receivedNs = stamp;
+                if (!queue.tryPush(event)) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            pending.erase(0, start);
+        }
+    }
+};
+
+// Latency samples in nanoseconds with mean/percentile reporting.
+struct LatencySamples {
+    static constexpr std::size_t SAMPLES = 4096;
+
+    std::uint64_t count = 0;
+    std::int64_t maxNs = 0;
+    double sumNs = 0;
+    std::array<std::int64_t, SAMPLES> recent {};  // Ring of the latest samples for percentiles
+
+    void record(std::int64_t ns) {
+        recent[count % SAMPLES] = ns;
+        ++count;
+        sumNs += static_cast<double>(ns);
+        maxNs = std::max(maxNs, ns);
+    }
+
+    void report(std::ostream& out) const {
+        out << count << " events";
+        if (count == 0) {
+            return;
+        }
+        std::vector<std::int64_t> sorted(recent.begin(), recent.begin() + std::min<std::uint64_t>(count, SAMPLES));
+        std::sort(sorted.begin(), sorted.end());
+        auto pct = [&sorted](double p) { return sorted[static_cast<std::size_t>(p * (sorted.size() - 1))] / 1e3; };
+        out << ", mean " << sumNs / count / 1e3 << " us"
+            << ", p50 " << pct(0.50) << " us"
+            << ", p99 " << pct(0.99) << " us"
+            << ", max " << maxNs / 1e3 << " us";
+    }
+};
+
+// Injection statistics. An event is ready when it has been read and its requested time (if any)
+// has come: latency runs from then to the adapter's output on the Rifle ports. Timed events also
+// record lateness, which is output against the requested time alone.
+struct InputLatencyStats {
+    std::int64_t originNs = 0;       // Wall clock at simulation time 0, taken at the first transition
+    std::uint64_t late = 0;          // Timed events read after their requested time had passed
+    LatencySamples latency;
+    LatencySamples lateness;
+
+    [[nodiscard]] std::int64_t dueNs(double time) const {
+        return originNs + static_cast<std::int64_t>(time * 1e9);
+    }
+
+    void report(std::ostream& out) const {
+        out << "External input latency (ready to injected): ";
+        latency.report(out);
+        out << std::endl << "External input lateness (requested time to injected): ";
+        lateness.report(out);
+        out << ", " << late << " read after their time" << std::endl;
+    }
+};
+
+struct RifleInputAdapterState {
+    double sigma;
+    double clock;                // Simulation time of the last transition
+    double backoff;              // Next idle poll period; doubles while the queue stays empty
+    bool emit;                   // The front waiting event is output when sigma expires
+    std::vector<ExternalInputEvent> waiting;  // Read but not yet injected, ordered by time
+
+    explicit RifleInputAdapterState(double pollPeriod)
+        : sigma(pollPeriod), clock(0), backoff(pollPeriod), emit(false), waiting() {}
+};
+
+#ifndef NO_LOGGING
+std::ostream& operator<<(std::ostream &out, const RifleInputAdapterState& state) {
+    out << "{" << state.sigma << ", waiting: " << state.waiting.size() << "}";
+    return out;
+}
+#endif
+
+// Injects events from an ExternalInputSource into Rifle's trigger and selector ports.
+// Cadmium's RT clock cannot be woken from another thread, so the adapter polls the queue. Right
+// after an event arrives it polls every pollPeriod. The period then doubles while the queue stays
+// empty, up to idlePeriod. A burst of input therefore sees pollPeriod latency, the first event after
+// a quiet spell sees at most idlePeriod, and an idle adapter costs 1/idlePeriod transitions per
+// second. Its state is kept out of the log (see LogFilter.hpp).
+//
+// Each poll drains the queue into a time-ordered buffer of up to BUFFER_SIZE events (untimed
+// events are due at once), so a future-timed event never holds up the ones read after it. The
+// adapter wakes at the next poll or the earliest due time, whichever comes first, and injects one
+// due event per transition.
+class RifleInputAdapter : public Atomic<RifleInputAdapterState> {
+public:
+    static constexpr std::size_t BUFFER_SIZE = 256;
+
+    Port<int> out_triggerPressed;
+    Port<int> out_firingSelector;
+
+    RifleInputAdapter(const std::string& id, const std::string& path = "-", double pollPeriod = 0.001, double idlePeriod = 0.1)
+        : Atomic<RifleInputAdapterState>(id, RifleInputAdapterState(pollPeriod)),
+          source(std::make_shared<ExternalInputSource>(path)),
+          stats(std::make_shared<InputLatencyStats>()),
+          POLL_PERIOD(pollPeriod),
+          IDLE_PERIOD(std::max(idlePeriod, pollPeriod))
+    {
+        out_triggerPressed = addOutPort<int>("out_triggerPressed");
+        out_firingSelector = addOutPort<int>("out_firingSelector");
+        state.waiting.reserve(BUFFER_SIZE);
+        excludeFromLog(id);
+    }
+
+    void internalTransition(RifleInputAdapterState& state) const override {
+        state.clock += state.sigma;
+        if (stats->originNs == 0) {
+            stats->originNs = ExternalInputSource::nowNs() - static_cast<std::int64_t>(state.clock * 1e9);
+        }
+        if (state.emit) {
+            state.waiting.erase(state.waiting.begin());
+            state.emit = false;
+        }
+
+        bool arrived = false;
+        ExternalInputEvent event {};
+        while (state.waiting.size() < BUFFER_SIZE && source->pop(event)) {
+            arrived = true;
+            if (event.time < 0) {
+                event.time = state.clock;   // Untimed: due now, after anything already due
+            } else if (event.time < state.clock) {
+                stats->late++;
+            }
+            auto at = std::upper_bound(state.waiting.begin(), state.waiting.end(), event,
+                [](const ExternalInputEvent& a, const ExternalInputEvent& b) { return a.time < b.time; });
+            state.waiting.insert(at, event);
+        }
+
+        double poll = state.backoff;
+        if (arrived) {
+            poll = POLL_PERIOD;
+            state.backoff = POLL_PERIOD;
+        } else {
+            state.backoff = std::min(2 * state.backoff, IDLE_PERIOD);
+        }
+        if (!state.waiting.empty()) {
+            double due = std::max(0.0, state.waiting.front().time - state.clock);
+            if (due <= poll) {
+                state.emit = true;
+                state.sigma = due;
+                return;
+            }
+        }
+        state.sigma = poll;
+    }
+
+    void externalTransition(RifleInputAdapterState& state, double e) const override {}
+
+    void output(const RifleInputAdapterState& state) const override {
+        if (!state.emit) {
+            return;
+        }
+        const ExternalInputEvent& event = state.waiting.front();
+        if (event.target == ExternalInputEvent::Target::TRIGGER) {
+            out_triggerPressed->addMessage(event.value);
+        } else {
+            out_firingSelector->addMessage(event.value);
+        }
+        const std::int64_t now = ExternalInputSource::nowNs();
+        const std::int64_t due = stats->dueNs(event.time);
+        // The origin is estimated at the first transition, so clamp tiny negative values
+        stats->latency.record(std::max<std::int64_t>(0, now - std::max(event.receivedNs, due)));
+        if (event.timed) {
+            stats->lateness.record(std::max<std::int64_t>(0, now - due));
+        }
+    }
+
+    [[nodiscard]] double timeAdvance(const RifleInputAdapterState& state) const override {
+        return state.sigma;
+    }
+
+    void report(std::ostream& out) const {
+        stats->report(out);
+        if (source->droppedEvents() != 0 || source->rejectedLines() != 0) {
+            out << "External input: " << source->droppedEvents() << " dropped (queue full), "
+                << source->rejectedLines() << " malformed lines" << std::endl;
+        }
+    }
+
+private:
+    std::shared_ptr<ExternalInputSource> source;
+    std::shared_ptr<InputLatencyStats> stats;
+    const double POLL_PERIOD;
+    const double IDLE_PERIOD;
+};
+
+#endif // RIFLEINPUTADAPTER_HPP
@@ -0,0 +1,95 @@
+#ifndef RIFLEMETRICS_HPP
+#define RIFLEMETRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/*
+Process-wide rifle counters. The simulation thread is the only writer and does relaxed loads and
+stores (no locked read-modify-write), so readers on other threads (the metrics exporter, progress
+reporting) never slow it down. The models publish their clock with every transition, so sim time
+needs no extra model to keep it current.
+
+Counting is compiled in on Linux/ Windows, for the metrics endpoint and the run mode (progress
+lines and the final totals). On the ESP32 it compiles to nothing: 64-bit and double atomics are
+not lock-free on Xtensa, and there is no exporter to read them.
+*/
+
+#if defined(RIFLE_METRICS) && defined(ESP_PLATFORM)
+#error "RIFLE_METRICS is not supported on the ESP32: its 64-bit and double atomics take a lock"
+#endif
+
+using MetricCount = std::uint64_t;
+
+#ifdef ESP_PLATFORM
+constexpr bool COUNT_METRICS = false;
+#else
+constexpr bool COUNT_METRICS = true;
+#endif
+
+struct RifleMetrics {
+    std::atomic<MetricCount> events {0};        // Atomic model transitions
+    std::atomic<MetricCount> roundsFired {0};
+    std::atomic<MetricCount> jams {0};          // Bullets that failed to load
+    std::atomic<MetricCount> duds {0};
+    std::atomic<double> simTime {0};            // Time of the latest model transition
+    std::atomic<std::int64_t> wallStartNs {0};
+    std::atomic<std::int64_t> latenessNs {0};   // RT only: wall time behind sim time at the last sample
+    std::atomic<std::int64_t> maxLatenessNs {0};
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Wall-clock origin for rates and lateness; call right before the simulation starts.
+    void markStart() {
+        wallStartNs.store(nowNs(), std::memory_order_relaxed);
+    }
+
+    // RT lateness needs a clock read, so it is sampled once every LATENESS_SAMPLE events.
+    static constexpr MetricCount LATENESS_SAMPLE = 64;
+
+    void publishSimTime(double time) {
+        simTime.store(time, std::memory_order_relaxed);
+    #if defined(RIFLE_METRICS) && !defined(SIM_TIME)
+        if (events.load(std::memory_order_relaxed) % LATENESS_SAMPLE != 0) {
+            return;
+        }
+        std::int64_t late = nowNs() - wallStartNs.load(std::memory_order_relaxed) - static_cast<std::int64_t>(time * 1e9);
+        late = late > 0 ? late : 0;
+        latenessNs.store(late, std::memory_order_relaxed);
+        if (late > maxLatenessNs.load(std::memory_order_relaxed)) {
+            maxLatenessNs.store(late, std::memory_order_relaxed);  // Single writer, no CAS needed
+        }
+    #endif
+    }
+};
+
+RifleMetrics& rifleMetrics() {
+    static RifleMetrics metrics;
+    return metrics;
+}
+
+// Single writer, so a relaxed load and store replace the locked fetch_add.
+inline void bumpMetric(std::atomic<MetricCount>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+inline void countMetric(std::atomic<MetricCount> RifleMetrics::*counter) {
+    if constexpr (COUNT_METRICS) {
+        bumpMetric(rifleMetrics().*counter);
+    }
+}
+
+// One model transition at simulation time `time`.
+inline void countEvent(double time) {
+    if constexpr (COUNT_METRICS) {
+        RifleMetrics& metrics = rifleMetrics();
+        bumpMetric(metrics.events);
+        metrics.publishSimTime(time);
+    }
+}
+
+#endif // RIFLEMETRICS_HPP
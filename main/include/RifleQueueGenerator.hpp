@@ -4,6 +4,7 @@
 #include <iostream>
 #include <limits>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "MemoryAccounting.hpp"
 
 using namespace cadmium;
 
@@ -46,7 +47,7 @@ std::ostream& operator<<(std::ostream &out, const RifleQueueGeneratorState& stat
 #endif
 
 // RifleQueueGenerator atomic model: Generates test events for 3 scenarios.
-class RifleQueueGenerator : public Atomic<RifleQueueGeneratorState> {
+class RifleQueueGenerator : public Atomic<RifleQueueGeneratorState>, public AccountedModel {
 public:
     Port<int> out_triggerPressed;
     Port<int> out_firingSelector;
@@ -68,6 +69,7 @@ public:
 
 
     void internalTransition(RifleQueueGeneratorState& state) const override {
+        auto scope = memScope();
         state.messages_sent++;
 
         if(state.test_phase == 1) {
@@ -116,6 +118,7 @@ public:
 
 
     void output(const RifleQueueGeneratorState& state) const override {
+        auto scope = memScope();
         out_triggerPressed->addMessage(state.trigger_pressed ? 1 : 0);
         out_firingSelector->addMessage(state.firing_mode);
         out_boltBack->addMessage(state.bolt_back ? 1 : 0);
@@ -0,0 +1,23 @@
+#ifndef RIFLERANDOM_HPP
+#define RIFLERANDOM_HPP
+
+#include <cstdint>
+#include <random>
+
+// Shared random engine for the rifle models. Seeded from std::random_device unless a run
+// fixes the seed with seedRifleRandom(), which makes the whole simulation reproducible.
+std::mt19937& rifleRandom() {
+    static std::mt19937 engine {std::random_device{}()};
+    return engine;
+}
+
+void seedRifleRandom(std::uint32_t seed) {
+    rifleRandom().seed(seed);
+}
+
+// Uniform draw in [0, 1)
+inline double uniformDraw() {
+    return std::uniform_real_distribution<>(0.0, 1.0)(rifleRandom());
+}
+
+#endif // RIFLERANDOM_HPP
@@ -0,0 +1,121 @@
+#ifndef RIFLETRANSITIONTABLES_HPP
+#define RIFLETRANSITIONTABLES_HPP
+
+#include <array>
+#include <cstdint>
+
+/*
+Lookup tables for the TrigAssy output and the BoltAssy external transition.
+
+Each table is generated at compile time from a rule function that mirrors the hand-written
+reference code in the model (kept as outputReference() / externalTransitionReference() and
+selected with -DREFERENCE_TRANSITIONS). The models pack their state and inputs into a small
+code, read one entry and apply it without branching on the state. Randomness is applied last
+by picking one of the entry's outcomes. The tables and code helpers are free of any model
+instance so that several engines can share them.
+*/
+
+// ---------------------------------------------------------------- TrigAssy output
+// code = triggerPulled << 2 | selector (0 = safe, 1 = single, 2 = auto, 3 = anything else)
+
+struct TrigOutputStep {
+    bool emit;   // Write out_releaseBolt
+    int value;   // Value written
+};
+
+constexpr unsigned trigOutputCode(int triggerPull, int firingSelector) {
+    unsigned selector = static_cast<unsigned>(firingSelector) < 3 ? static_cast<unsigned>(firingSelector) : 3u;
+    return (static_cast<unsigned>(triggerPull == 1) << 2) | selector;
+}
+
+constexpr TrigOutputStep trigOutputRule(unsigned code) {
+    bool pulled = (code >> 2) & 1;
+    unsigned selector = code & 3;
+    if (!pulled || selector == 3) {
+        return {false, 0};
+    }
+    return {true, selector == 0 ? 0 : 1};  // Safe keeps the bolt locked, single/auto release it
+}
+
+constexpr std::array<TrigOutputStep, 8> makeTrigOutputTable() {
+    std::array<TrigOutputStep, 8> table {};
+    for (unsigned code = 0; code < table.size(); ++code) {
+        table[code] = trigOutputRule(code);
+    }
+    return table;
+}
+
+inline constexpr std::array<TrigOutputStep, 8> TRIG_OUTPUT = makeTrigOutputTable();
+
+static_assert(!TRIG_OUTPUT[trigOutputCode(0, 2)].emit, "no output without a trigger pull");
+static_assert(TRIG_OUTPUT[trigOutputCode(1, 0)].emit && TRIG_OUTPUT[trigOutputCode(1, 0)].value == 0, "safe");
+static_assert(TRIG_OUTPUT[trigOutputCode(1, 2)].emit && TRIG_OUTPUT[trigOutputCode(1, 2)].value == 1, "auto");
+
+// ---------------------------------------------------------------- BoltAssy external transition
+// code bits: 0-1 boltState (0 = forward, 1 = back, 2 = issue), 2 boltFree, 3 readyBullet == 1,
+//            4 releaseBolt present, 5 releaseBolt == 1, 6 boltBack == 1
+
+struct BoltStep {
+    std::uint8_t boltState[2];  // Next boltState: [0] load succeeded, [1] load failed
+    std::uint8_t boltFree;
+    bool clearReady;            // readyBullet is consumed
+    bool activate;              // Go ACTIVE with sigma = 0
+    bool released;              // The release message freed the bolt
+};
+
+constexpr unsigned boltCode(int boltState, int boltFree, int readyBullet,
+                            bool releasePresent, bool releaseOne, bool boltBackOne) {
+    return (static_cast<unsigned>(boltState) & 3u)
+         | (static_cast<unsigned>(boltFree & 1) << 2)
+         | (static_cast<unsigned>(readyBullet == 1) << 3)
+         | (static_cast<unsigned>(releasePresent) << 4)
+         | (static_cast<unsigned>(releasePresent && releaseOne) << 5)
+         | (static_cast<unsigned>(boltBackOne) << 6);
+}
+
+constexpr BoltStep boltRule(unsigned code) {
+    int boltState = static_cast<int>(code & 3);
+    int boltFree = static_cast<int>((code >> 2) & 1);
+    bool ready = (code >> 3) & 1;
+    bool releasePresent = (code >> 4) & 1;
+    bool releaseOne = (code >> 5) & 1;
+    bool boltBackOne = (code >> 6) & 1;
+
+    BoltStep step {};
+    if (releasePresent) {
+        if (releaseOne && boltState == 1) {
+            boltFree = 1;
+            step.released = true;
+        }
+    } else if (boltBackOne) {
+        boltState = boltState == 0 ? 1 : (boltState == 1 ? 0 : boltState);
+    }
+
+    step.boltState[0] = step.boltState[1] = static_cast<std::uint8_t>(boltState);
+    if (boltFree == 1 && boltState == 1) {
+        step.boltState[0] = 0;
+        step.boltState[1] = ready ? 2 : 0;  // Only a ready bullet can fail to load
+        boltFree = 0;
+        step.clearReady = true;
+        step.activate = true;
+    }
+    step.boltFree = static_cast<std::uint8_t>(boltFree);
+    return step;
+}
+
+constexpr std::array<BoltStep, 128> makeBoltTable() {
+    std::array<BoltStep, 128> table {};
+    for (unsigned code = 0; code < table.size(); ++code) {
+        table[code] = boltRule(code);
+    }
+    return table;
+}
+
+inline constexpr std::array<BoltStep, 128> BOLT_TRANSITIONS = makeBoltTable();
+
+static_assert(BOLT_TRANSITIONS[boltCode(1, 0, 1, true, true, false)].boltState[1] == 2, "a ready bullet can jam");
+static_assert(BOLT_TRANSITIONS[boltCode(1, 0, 0, true, true, false)].boltState[1] == 0, "an empty feed cannot jam");
+static_assert(BOLT_TRANSITIONS[boltCode(0, 0, 0, false, false, true)].boltState[0] == 1, "bolt back from forward");
+static_assert(!BOLT_TRANSITIONS[boltCode(1, 0, 1, true, false, true)].activate, "a release message hides bolt back");
+
+#endif // RIFLETRANSITIONTABLES_HPP
@@ -0,0 +1,179 @@
+#ifndef RUNMODE_HPP
+#define RUNMODE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include "RifleMetrics.hpp"
+
+/*
+Command-line run mode (Linux/ Windows). Everything a long run keeps between flushes is a handful
+of counters, so memory stays flat however long the horizon is.
+
+    sample_project [--horizon T] [--seed N] [--messages N] [--log stdout|csv:<file>|none]
+                   [--flush-interval T] [--summary <file>]
+*/
+
+struct RunOptions {
+    double horizon = 23.0;          // Simulation time to run for
+    std::uint32_t seed = 0;
+    bool seeded = false;            // false: seed drawn from std::random_device
+    int messages = 30;              // Events sent by the rifle queue generator
+    std::string log = "stdout";     // stdout, csv:<file> or none
+    double flushInterval = 0;       // Sim time between progress lines / summary rows (0 = off)
+    std::string summary;            // CSV file for the per-interval aggregates
+    bool help = false;              // --help was given; usage already printed
+};
+
+void printUsage(std::ostream& out, const char* program) {
+    out << "Usage: " << program << " [options]\n"
+        << "  --horizon T          simulation time to run (default 23, 'inf' for no limit)\n"
+        << "  --seed N             seed the model random engine (default: random)\n"
+        << "  --messages N         events sent by the rifle queue generator (default 30)\n"
+        << "  --log SINK           stdout, csv:<file> or none (default stdout)\n"
+        << "  --flush-interval T   print progress and flush aggregates every T time units\n"
+        << "  --summary FILE       write per-interval aggregates as CSV (needs --flush-interval)\n"
+        << "  --help               show this message\n";
+}
+
+// Returns false (after printing the reason) on a malformed command line.
+bool parseRunOptions(int argc, char* argv[], RunOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            printUsage(std::cout, argv[0]);
+            options.help = true;
+            return true;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << "\n";
+            printUsage(std::cerr, argv[0]);
+            return false;
+        }
+        const std::string value = argv[++i];
+        try {
+            if (flag == "--horizon") {
+                options.horizon = std::stod(value);
+            } else if (flag == "--seed") {
+                options.seed = static_cast<std::uint32_t>(std::stoul(value));
+                options.seeded = true;
+            } else if (flag == "--messages") {
+                options.messages = std::stoi(value);
+            } else if (flag == "--log") {
+                options.log = value;
+            } else if (flag == "--flush-interval") {
+                options.flushInterval = std::stod(value);
+            } else if (flag == "--summary") {
+                options.summary = value;
+            } else {
+                std::cerr << "Unknown option " << flag << "\n";
+                printUsage(std::cerr, argv[0]);
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value '" << value << "' for " << flag << "\n";
+            return false;
+        }
+    }
+    if (options.log != "stdout" && options.log != "none" && options.log.rfind("csv:", 0) != 0) {
+        std::cerr << "Unknown log sink '" << options.log << "'\n";
+        return false;
+    }
+    if (!(options.horizon > 0) || options.flushInterval < 0 || options.messages < 0) {
+        std::cerr << "--horizon must be positive, --flush-interval and --messages non-negative\n";
+        return false;
+    }
+    if (!options.summary.empty() && options.flushInterval == 0) {
+        std::cerr << "--summary needs --flush-interval\n";
+        return false;
+    }
+    if (!options.seeded) {
+        options.seed = std::random_device{}();
+    }
+    return true;
+}
+
+// Heartbeat callback: one progress line on stderr and one aggregate row per flush interval.
+// Rows hold deltas since the previous flush; the totals live in RifleMetrics.
+class ProgressReporter {
+public:
+    ProgressReporter(double horizon, const std::string& summaryPath)
+        : horizon(horizon), lastSimTime(0), lastWallNs(0), last() {
+        if (!summaryPath.empty()) {
+            summary.open(summaryPath);
+            if (!summary) {
+                std::cerr << "[progress] cannot open summary file '" << summaryPath << "'" << std::endl;
+            }
+            summary << "sim_time,wall_seconds,events,rounds_fired,jams,duds\n";
+        }
+    }
+
+    // Final flush once the run has stopped: covers the interval since the last beat, which a beat
+    // at the horizon itself would have flushed had the coordinator run it. No-op on an unbounded run.
+    void finish(double horizonTime) {
+        if (horizonTime != std::numeric_limits<double>::infinity() && horizonTime > lastSimTime) {
+            (*this)(horizonTime);
+        }
+    }
+
+    void operator()(double simTime) {
+        const RifleMetrics& metrics = rifleMetrics();
+        const std::int64_t now = RifleMetrics::nowNs();
+        const std::int64_t start = metrics.wallStartNs.load(std::memory_order_relaxed);
+        if (lastWallNs == 0) {
+            lastWallNs = start;
+        }
+        const Counts current {
+            metrics.events.load(std::memory_order_relaxed),
+            metrics.roundsFired.load(std::memory_order_relaxed),
+            metrics.jams.load(std::memory_order_relaxed),
+            metrics.duds.load(std::memory_order_relaxed),
+        };
+        const double wall = (now - start) / 1e9;
+        const double interval = (now - lastWallNs) / 1e9;
+        const double simRate = interval > 0 ? (simTime - lastSimTime) / interval : 0.0;
+        const double eventRate = interval > 0 ? (current.events - last.events) / interval : 0.0;
+
+        const std::ios_base::fmtflags flags = std::cerr.flags();
+        const std::streamsize precision = std::cerr.precision();
+        std::cerr << std::setprecision(6) << "[progress] sim " << simTime;
+        if (horizon != std::numeric_limits<double>::infinity()) {
+            std::cerr << " (" << std::fixed << std::setprecision(1) << 100.0 * simTime / horizon << "%)" << std::defaultfloat;
+        }
+        std::cerr << std::setprecision(3) << " | wall " << wall << " s | " << simRate << " sim/s | "
+                  << eventRate << " events/s | fired " << current.roundsFired << ", jams " << current.jams
+                  << ", duds " << current.duds << std::endl;
+        std::cerr.flags(flags);
+        std::cerr.precision(precision);
+
+        if (summary.is_open()) {
+            summary << simTime << "," << wall << "," << current.events - last.events << ","
+                    << current.roundsFired - last.roundsFired << "," << current.jams - last.jams << ","
+                    << current.duds - last.duds << std::endl;  // endl: flushed every interval
+        }
+
+        last = current;
+        lastSimTime = simTime;
+        lastWallNs = now;
+    }
+
+private:
+    struct Counts {
+        MetricCount events = 0;
+        MetricCount roundsFired = 0;
+        MetricCount jams = 0;
+        MetricCount duds = 0;
+    };
+
+    const double horizon;
+    double lastSimTime;
+    std::int64_t lastWallNs;
+    Counts last;
+    std::ofstream summary;
+};
+
+#endif // RUNMODE_HPP
@@ -0,0 +1,186 @@
+#ifndef SHOTTRACE_HPP
+#define SHOTTRACE_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/*
+Per-shot latency tracing (enabled with SHOT_TRACE).
+
+BoltAssy opens a shot when a trigger pull actually frees the bolt, so every shot goes on to be
+fed; pulls the bolt ignores (safe, bolt forward) open nothing. The shot ID then rides in the
+upper bits of the int messages on the firing path (bulletLoaded -> bulletReady -> isDud ->
+boltBack), so each model knows which round it is handling and stamps its stage into a
+preallocated ring of shot records. Stamps are simulation time, which the models keep by
+accumulating sigma and e, so the breakdown shows where the model's cycle time goes (e.g.
+Chamber's firing delay) in both SIM_TIME and RT runs. RT builds also take a steady_clock stamp
+and report the wall-clock breakdown as extra columns.
+
+Without SHOT_TRACE the tag helpers are identities and the stamps compile away.
+*/
+
+enum class ShotStage : std::uint8_t {
+    TRIGGER,    // BoltAssy: trigger pull frees the bolt, opening the shot
+    FEED,       // BoltAssy: bullet loaded (or failed to load)
+    CHAMBER,    // Chamber: round chambered
+    DUD_CHECK,  // Bullet: dud decided
+    FIRE,       // Chamber: round fired, bolt sent back
+    BOLT_BACK,  // BoltAssy: bolt back received
+    COUNT
+};
+
+// Message values on the firing path are small flags, so the low byte holds the value and the
+// remaining bits the shot ID (kept below 2^23 so tagged messages stay positive).
+constexpr int SHOT_VALUE_BITS = 8;
+constexpr std::uint32_t SHOT_ID_MASK = (1u << (31 - SHOT_VALUE_BITS)) - 1;
+
+#ifdef SHOT_TRACE
+constexpr int tagShot(int value, std::uint32_t shot) {
+    return static_cast<int>((shot & SHOT_ID_MASK) << SHOT_VALUE_BITS) | (value & ((1 << SHOT_VALUE_BITS) - 1));
+}
+constexpr int shotValue(int msg) { return msg & ((1 << SHOT_VALUE_BITS) - 1); }
+constexpr std::uint32_t shotOf(int msg) { return static_cast<std::uint32_t>(msg) >> SHOT_VALUE_BITS; }
+#else
+constexpr int tagShot(int value, std::uint32_t) { return value; }
+constexpr int shotValue(int msg) { return msg; }
+constexpr std::uint32_t shotOf(int) { return 0; }
+#endif
+
+class ShotTracer {
+public:
+    static constexpr std::size_t STAGES = static_cast<std::size_t>(ShotStage::COUNT);
+
+    explicit ShotTracer(std::size_t capacity = 1024) : records(capacity), next(1), opened(0) {}
+
+    // Allocates a shot ID (never 0, which means "untraced") and stamps the trigger stage.
+    std::uint32_t begin(double time) {
+        std::uint32_t shot = next;
+        ++opened;
+        next = (next & SHOT_ID_MASK) == SHOT_ID_MASK ? 1 : next + 1;
+        Record& record = records[shot % records.size()];
+        record.shot = shot;
+        record.stamped = 0;
+        stamp(shot, ShotStage::TRIGGER, time);
+        return shot;
+    }
+
+    // First stamp of a stage wins; stamps for untraced or overwritten shots are ignored.
+    void stamp(std::uint32_t shot, ShotStage stage, double time) {
+        Record& record = records[shot % records.size()];
+        const auto index = static_cast<std::size_t>(stage);
+        if (shot == 0 || record.shot != shot || record.reached(index)) {
+            return;
+        }
+        record.stamped |= 1u << index;
+        record.time[index] = time;
+    #ifndef SIM_TIME
+        record.ns[index] = nowNs();
+    #endif
+    }
+
+    void report(std::ostream& out) const {
+    #ifdef SIM_TIME
+        out << "Shot latency (sim time): stage, shots, mean, p50, p90, p99, max" << std::endl;
+    #else
+        out << "Shot latency (sim time): stage, shots, mean, p50, p90, p99, max | wall us: mean, p99, max" << std::endl;
+    #endif
+        out << "opened, " << opened << " (latest " << std::min<std::uint64_t>(opened, records.size()) << " kept)" << std::endl;
+        for (std::size_t stage = 1; stage <= STAGES; ++stage) {
+            // Each stage is measured from the latest earlier stage the shot reached;
+            // the last row is trigger to bolt back.
+            bool total = stage == STAGES;
+            std::vector<double> sim = deltas(stage, [](const Record& r, std::size_t from, std::size_t to) {
+                return r.time[to] - r.time[from];
+            });
+            out << (total ? "total" : STAGE_NAMES[stage]) << ", " << sim.size();
+            if (sim.empty()) {
+                out << std::endl;
+                continue;
+            }
+            out << ", " << mean(sim) << ", " << percentile(sim, 0.50) << ", " << percentile(sim, 0.90)
+                << ", " << percentile(sim, 0.99) << ", " << sim.back();
+        #ifndef SIM_TIME
+            std::vector<double> wall = deltas(stage, [](const Record& r, std::size_t from, std::size_t to) {
+                return (r.ns[to] - r.ns[from]) / 1e3;
+            });
+            out << " | " << mean(wall) << ", " << percentile(wall, 0.99) << ", " << wall.back();
+        #endif
+            out << std::endl;
+        }
+    }
+
+private:
+    static constexpr const char* STAGE_NAMES[STAGES] = {"trigger", "feed", "chamber", "dud_check", "fire", "bolt_back"};
+
+    struct Record {
+        std::uint32_t shot = 0;
+        std::uint32_t stamped = 0;              // Bit per stage reached
+        std::array<double, STAGES> time {};     // Simulation time per stage
+    #ifndef SIM_TIME
+        std::array<std::int64_t, STAGES> ns {}; // steady_clock per stage (RT builds)
+    #endif
+
+        [[nodiscard]] bool reached(std::size_t stage) const { return (stamped >> stage) & 1u; }
+    };
+
+    std::vector<Record> records;  // Ring indexed by shot ID, allocated once
+    std::uint32_t next;
+    std::uint64_t opened;         // Shots begun over the whole run
+
+    // Sorted per-shot deltas for one report row, as given by delta(record, fromStage, toStage).
+    template <typename Delta>
+    std::vector<double> deltas(std::size_t stage, Delta delta) const {
+        bool total = stage == STAGES;
+        std::vector<double> values;
+        values.reserve(records.size());
+        for (const auto& record : records) {
+            std::size_t to = total ? STAGES - 1 : stage;
+            if (record.shot == 0 || !record.reached(to)) {
+                continue;
+            }
+            std::size_t from = total ? 0 : stage - 1;
+            while (from > 0 && !record.reached(from)) {
+                --from;
+            }
+            values.push_back(delta(record, from, to));
+        }
+        std::sort(values.begin(), values.end());
+        return values;
+    }
+
+    static double mean(const std::vector<double>& values) {
+        double sum = 0;
+        for (double v : values) {
+            sum += v;
+        }
+        return sum / values.size();
+    }
+
+    static double percentile(const std::vector<double>& sorted, double p) {
+        return sorted[static_cast<std::size_t>(p * (sorted.size() - 1))];
+    }
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#ifdef SHOT_TRACE
+ShotTracer& shotTracer() {
+    static ShotTracer tracer;
+    return tracer;
+}
+
+inline std::uint32_t beginShot(double time) { return shotTracer().begin(time); }
+inline void stampShot(std::uint32_t shot, ShotStage stage, double time) { shotTracer().stamp(shot, stage, time); }
+#else
+inline std::uint32_t beginShot(double) { return 0; }
+inline void stampShot(std::uint32_t, ShotStage, double) {}
+#endif
+
+#endif // SHOTTRACE_HPP
@@ -4,6 +4,11 @@
 #include <limits>   // for std::numeric_limits
 #include <iostream>
 #include "cadmium/modeling/devs/atomic.hpp"
+#include "DeadPortElimination.hpp"
+#include "MemoryAccounting.hpp"
+#include "ShotTrace.hpp"
+#include "RifleMetrics.hpp"
+#include "RifleTransitionTables.hpp"
 
 using namespace cadmium;
 
@@ -17,13 +22,15 @@ struct TrigAssyState {
     
     int triggerPull;     // 0 or 1
     int firingSelector;  // 0 = safe, 1 = single, 2 = auto
+    double clock;        // Simulation time of the last transition
 
     
-    TrigAssyState()
+    constexpr TrigAssyState()
         : currentState(States::PASSIVE),
           sigma(std::numeric_limits<double>::infinity()), 
           triggerPull(0),
-          firingSelector(1) {}  
+          firingSelector(1),
+          clock(0) {}  
 };
 
 #ifndef NO_LOGGING
@@ -35,7 +42,7 @@ std::ostream& operator<<(std::ostream &out, const TrigAssyState &state) {
 }
 #endif
 
-class TrigAssy : public Atomic<TrigAssyState> {
+class TrigAssy : public Atomic<TrigAssyState>, public PrunableOutputs, public AccountedModel {
 public:
     
     Port<int> in_triggerPressed;
@@ -58,6 +65,9 @@ public:
 
 
     void internalTransition(TrigAssyState &s) const override {
+        auto scope = memScope();
+        s.clock += s.sigma;
+        countEvent(s.clock);
         // If in single-shot mode and the trigger was pressed → reset the trigger
         if (s.firingSelector == 1 && s.triggerPull == 1) {
             s.triggerPull = 0; 
@@ -69,6 +79,9 @@ public:
 
 
     void externalTransition(TrigAssyState &s, double e) const override {
+        auto scope = memScope();
+        s.clock += e;
+        countEvent(s.clock);
         
         if (!in_triggerPressed->empty()) {
             s.triggerPull = in_triggerPressed->getBag().back();  
@@ -81,14 +94,28 @@ public:
         if (!in_boltBack->empty()) {
             
         }
-        
+
         s.currentState = TrigAssyState::States::ACTIVE;
         s.sigma = 0.0;
     }
 
+    // Table-driven output (see RifleTransitionTables.hpp)
     void output(const TrigAssyState &s) const override {
+        auto scope = memScope();
+    #ifdef REFERENCE_TRANSITIONS
+        outputReference(s);
+    #else
+        const TrigOutputStep& step = TRIG_OUTPUT[trigOutputCode(s.triggerPull, s.firingSelector)];
+        if (step.emit && live(out_releaseBolt)) {
+            out_releaseBolt->addMessage(step.value);
+        }
+    #endif
+    }
+
+    // Hand-written reference for the table above
+    void outputReference(const TrigAssyState &s) const {
       
-        if (s.triggerPull != 1) {
+        if (s.triggerPull != 1 || !live(out_releaseBolt)) {
             return; 
         }
 
@@ -123,6 +150,9 @@ public:
         return s.sigma;
     }
 
+    [[nodiscard]] const TrigAssyState& getState() const { return state; }
+    void setState(const TrigAssyState& snapshot) { state = snapshot; }
+
 
 };
 
@@ -2,21 +2,31 @@
 #define SAMPLE_TOP_HPP
 
 #include "cadmium/modeling/devs/coupled.hpp"
+#include "MemoryAccounting.hpp"
 #include "RifleQueueGenerator.hpp"
 #include "Rifle.hpp"
+#include "PackedRifleState.hpp"
+#include "DeadPortElimination.hpp"
+#if defined(EXTERNAL_INPUT) && !defined(SIM_TIME)
+    #include <cstdlib>
+    #include "RifleInputAdapter.hpp"
+#endif
 
 
 using namespace cadmium;
 
 struct top_coupled : public Coupled {
+    #if defined(EXTERNAL_INPUT) && !defined(SIM_TIME)
+    std::shared_ptr<RifleInputAdapter> input;
+    #endif
 
     /**
      * Constructor function for the blinkySystem model.
      * @param id ID of the blinkySystem model.
      */
-    top_coupled(const std::string& id) : Coupled(id) {
-        auto rifleGen = addComponent<RifleQueueGenerator>("rifleGen");
-        auto rifle = addComponent<Rifle>("rifle");
+    top_coupled(const std::string& id, int generatorMessages = 30) : Coupled(id) {
+        auto rifleGen = addAccountedComponent<RifleQueueGenerator>(*this, "rifleGen", generatorMessages);
+        auto rifle = addAccountedComponent<Rifle>(*this, "rifle");
       
         addCoupling(rifleGen->out_triggerPressed, rifle->in_triggerPressed);
         addCoupling(rifleGen->out_firingSelector, rifle->in_firingSelector);
@@ -24,6 +34,13 @@ struct top_coupled : public Coupled {
         addCoupling(rifleGen->out_magSeating, rifle->in_magSeating);
         addCoupling(rifleGen->out_bulletLoaded, rifle->in_bulletLoaded);
 
+        #if defined(EXTERNAL_INPUT) && !defined(SIM_TIME)
+        // Live trigger/selector events from $RIFLE_INPUT (stdin when unset)
+        const char* inputPath = std::getenv("RIFLE_INPUT");
+        input = addAccountedComponent<RifleInputAdapter>(*this, "rifleInput", inputPath ? inputPath : "-");
+        addCoupling(input->out_triggerPressed, rifle->in_triggerPressed);
+        addCoupling(input->out_firingSelector, rifle->in_firingSelector);
+        #endif
 
         
     }
@@ -1,11 +1,23 @@
 #include <limits>
 #include "include/top.hpp"
+#ifndef ESP_PLATFORM
+	#include "include/Heartbeat.hpp"
+	#include "include/RunMode.hpp"
+#endif
 
 /*
-There are 3 macros defined at compile time that changes the behaviour of the simulation.
+There are 8 macros defined at compile time that changes the behaviour of the simulation.
 --> SIM_TIME: This macro, when defined, runs the simulation in simulation time. Else, the simulation runs at wall clock.
 --> ESP_PLATFORM: When defined, the models are compiled for the ESP32 microcontroller. Else, compiles for Linux/ Windows
 --> NO_LOGGING: When defined, prevents logging (maybe useful in embedded situations)
+--> EXTERNAL_INPUT: When defined (real-time builds only), trigger/selector events are also read from $RIFLE_INPUT
+--> SHOT_TRACE: When defined, shot IDs are carried through the rifle and per-stage latencies are printed at the end
+--> REFERENCE_TRANSITIONS: When defined, TrigAssy and BoltAssy use their hand-written transitions instead of the lookup tables
+--> RIFLE_METRICS: When defined (Linux/ Windows only), live counters are served on $RIFLE_METRICS_ENDPOINT (default port 9464)
+--> MEM_ACCOUNTING: When defined, heap use is attributed to each component and a footprint report is printed at the end
+
+On Linux/ Windows the horizon, seed, log sink and periodic progress/summary flushes are set on the
+command line; run with --help for the options.
 */
 
 
@@ -23,6 +35,12 @@ There are 3 macros defined at compile time that changes the behaviour of the sim
 #ifndef NO_LOGGING
 	#include "cadmium/simulation/logger/stdout.hpp"
 	#include "cadmium/simulation/logger/csv.hpp"
+	#include "include/LogFilter.hpp"
+#endif
+
+#if defined(RIFLE_METRICS) && !defined(ESP_PLATFORM)
+	#include <cstdlib>
+	#include "include/MetricsExporter.hpp"
 #endif
 
 using namespace cadmium;
@@ -31,11 +49,53 @@ extern "C" {
 	#ifdef ESP_PLATFORM
 		void app_main() //starting point for ESP32 code
 	#else
-		int main()		//starting point for simulation code
+		int main(int argc, char* argv[])		//starting point for simulation code
 	#endif
 	{
+		#ifndef ESP_PLATFORM
+			RunOptions options;
+			if (!parseRunOptions(argc, argv, options)) {
+				return 1;
+			}
+			if (options.help) {
+				return 0;
+			}
+			seedRifleRandom(options.seed);
+			std::cerr << "[run] seed " << options.seed << ", horizon " << options.horizon << std::endl;
+		#endif
 	
-		auto model = std::make_shared<top_coupled> ("top");
+		#ifdef SHOT_TRACE
+			shotTracer();	// Allocate the trace buffer before any component scope opens (MEM_ACCOUNTING)
+		#endif
+
+		// Construction is charged to the "top" memory scope (MEM_ACCOUNTING)
+		std::shared_ptr<top_coupled> model;
+		#ifndef ESP_PLATFORM
+			std::shared_ptr<ProgressReporter> reporter;
+		#endif
+		{
+			MemScope scope("top");
+			#ifdef ESP_PLATFORM
+				model = std::make_shared<top_coupled> ("top");
+			#else
+				model = std::make_shared<top_coupled> ("top", options.messages);
+				if (options.flushInterval > 0) {
+					reporter = std::make_shared<ProgressReporter>(options.horizon, options.summary);
+					addAccountedComponent<Heartbeat>(*model, "progress", options.flushInterval, [reporter](double time) { (*reporter)(time); });
+				}
+			#endif
+		}
+
+		// Output ports nobody listens to are switched off unless a logger records them. The report goes to
+		// stderr so the stdout log stays parseable.
+		#ifdef NO_LOGGING
+			const bool logged = false;
+		#elif defined(ESP_PLATFORM)
+			const bool logged = true;
+		#else
+			const bool logged = options.log != "none";
+		#endif
+		eliminateDeadPorts(model, logged).print(std::cerr);
 		
 		#ifdef SIM_TIME
 			auto rootCoordinator = cadmium::RootCoordinator(model);
@@ -50,16 +110,59 @@ extern "C" {
 		#endif
 
 		#ifndef NO_LOGGING
-		rootCoordinator.setLogger<STDOUTLogger>(";");
+			#ifdef ESP_PLATFORM
+				rootCoordinator.setLogger<FilteredLogger<STDOUTLogger>>(";");
+			#else
+				if (options.log == "stdout") {
+					rootCoordinator.setLogger<FilteredLogger<STDOUTLogger>>(";");
+				} else if (options.log != "none") {
+					rootCoordinator.setLogger<FilteredLogger<CSVLogger>>(options.log.substr(4), ";");
+				}
+			#endif
 		#endif
 
-		rootCoordinator.start();
-		#ifdef ESP_PLATFORM
-			rootCoordinator.simulate(std::numeric_limits<double>::infinity());
-		#else
-			rootCoordinator.simulate(23.0);
+		// Start the wall clock first: the exporter's first scrape measures its rate from here
+		rifleMetrics().markStart();
+		#if defined(RIFLE_METRICS) && !defined(ESP_PLATFORM)
+			const char* metricsEndpoint = std::getenv("RIFLE_METRICS_ENDPOINT");
+			MetricsExporter exporter(metricsEndpoint ? metricsEndpoint : "9464");
+		#endif
+		{
+			MemScope scope("simulation");
+			rootCoordinator.start();
+			#ifdef ESP_PLATFORM
+				rootCoordinator.simulate(std::numeric_limits<double>::infinity());
+			#else
+				rootCoordinator.simulate(options.horizon);
+			#endif
+			rootCoordinator.stop();	
+		}
+
+		#ifndef ESP_PLATFORM
+			// The coordinator stops before a beat at the horizon itself, so flush the last interval here
+			if (reporter) {
+				reporter->finish(options.horizon);
+			}
+		#endif
+
+		#ifndef ESP_PLATFORM
+			const RifleMetrics& metrics = rifleMetrics();
+			std::cerr << "[run] done in " << (RifleMetrics::nowNs() - metrics.wallStartNs.load()) / 1e9 << " s: "
+					  << metrics.events.load() << " events, " << metrics.roundsFired.load() << " rounds fired, "
+					  << metrics.jams.load() << " jams, " << metrics.duds.load() << " duds" << std::endl;
+		#endif
+
+		#if defined(EXTERNAL_INPUT) && !defined(SIM_TIME)
+			model->input->report(std::cerr);
+		#endif
+
+		#ifdef SHOT_TRACE
+			shotTracer().report(std::cerr);
+		#endif
+
+		#ifdef MEM_ACCOUNTING
+			printMemoryReport(std::cerr);
 		#endif
-		rootCoordinator.stop();	
 
 		#ifndef ESP_PLATFORM
 			return 0;